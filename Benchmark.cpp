@@ -3,29 +3,65 @@
 #include <random>
 #include <iostream>
 #include <cstdint>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <string>
 #include "MatchingEngine.h"
+#include "FixProtocol.h"
+#include "OuchProtocol.h"
+
+// Stands in for the engine so decoding can be timed on its own
+struct DecodeSink {
+    uint64_t checksum = 0;
+    template <typename... Rest>
+    bool processNewOrder(uint64_t id, uint32_t price, uint32_t qty, bool is_buy, Rest...) {
+        checksum += id + price + qty + is_buy;
+        return true;
+    }
+    bool processCancel(uint64_t id) { checksum += id; return true; }
+    bool processModify(uint64_t id, uint32_t price, uint32_t qty) { checksum += id + price + qty; return true; }
+    size_t processMassCancel(uint32_t owner, uint32_t instrument) { checksum += owner + instrument; return 0; }
+};
+
+// Frame one FIX 4.4 message around body (tag=value fields, each ending in SOH)
+static void appendFix(std::string& out, const std::string& body) {
+    size_t start = out.size();
+    out += "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+    unsigned sum = 0;
+    for (size_t i = start; i < out.size(); ++i) sum += static_cast<uint8_t>(out[i]);
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", sum % 256);
+    out += trailer;
+}
 
 int main() {
     try {
-        std::cout << "Starting benchmark" << std::endl;
-        MatchingEngine engine;
-        const int NUM_ORDERS = 1000;
+        // The engine embeds its pools and price ladders, so keep it off the stack
+        auto engine = std::make_unique<MatchingEngine<>>();
+        const int NUM_ORDERS = 500000;
     
-    // Pre-generate raw order data to keep RNG out of the benchmark loop
-    struct RawOrder { uint32_t price; uint32_t qty; bool is_buy; };
-    std::vector<RawOrder> test_orders(NUM_ORDERS);
+    // Pre-generate raw order data to keep RNG out of the benchmark loop.
+    // Workload: GTC limits, price uniform over 5000-5050, qty 10-100, random
+    // side, fixed seed; latency is reported in ns/order
+    struct BenchOrder { uint32_t price; uint32_t qty; bool is_buy; };
+    std::vector<BenchOrder> test_orders(NUM_ORDERS);
     
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> price_dist(5000, 5050);
+    std::uniform_int_distribution<uint32_t> qty_dist(10, 100);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+
     for (int i = 0; i < NUM_ORDERS; ++i) {
-        test_orders[i] = {5000, 10, i % 2 == 0};
+        test_orders[i] = {price_dist(gen), qty_dist(gen), (bool)side_dist(gen)};
     }
 
     std::cout << "Starting benchmark loop" << std::endl;
     auto start = std::chrono::high_resolution_clock::now();
 
-    // for (int i = 0; i < NUM_ORDERS; ++i) {
-    //     if (i % 100 == 0) std::cout << "Processing order " << i << std::endl;
-    //     engine.processNewOrder(i, test_orders[i].price, test_orders[i].qty, test_orders[i].is_buy);
-    // }
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        engine->processNewOrder(i, test_orders[i].price, test_orders[i].qty, test_orders[i].is_buy);
+    }
 
     auto end = std::chrono::high_resolution_clock::now();
     // --- End Benchmark ---
@@ -34,9 +70,127 @@ int main() {
     
     std::cout << "--- Matching Engine Benchmark ---" << std::endl;
     std::cout << "Orders Processed: " << NUM_ORDERS << std::endl;
-    std::cout << "Trades Executed:  " << engine.getTradesExecuted() << std::endl;
+    std::cout << "Trades Executed:  " << engine->getTradesExecuted() << std::endl;
     std::cout << "Total Time:       " << elapsed.count() / 1000.0 << " ms" << std::endl;
-    std::cout << "Avg Latency:      " << elapsed.count() / NUM_ORDERS << " us/order" << std::endl;
+    std::cout << "Avg Latency:      " << elapsed.count() * 1000.0 / NUM_ORDERS << " ns/order" << std::endl;
+
+    // --- OUCH decode: the same orders as one contiguous receive buffer ---
+    std::vector<char> wire(NUM_ORDERS * sizeof(OuchEnterOrder));
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        OuchEnterOrder msg{'O', (uint64_t)i, 0, test_orders[i].is_buy ? 'B' : 'S', test_orders[i].qty,
+                           test_orders[i].price, 0, 0, 0, 0, 0, 0, 0};
+        std::memcpy(&wire[i * sizeof(OuchEnterOrder)], &msg, sizeof(msg));
+    }
+
+    DecodeSink sink;
+    OuchDecoder decoder;
+    start = std::chrono::high_resolution_clock::now();
+    size_t consumed = decoder.decode(wire.data(), wire.size(), sink);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> decode_ns = end - start;
+
+    // A socket read lands in a small, cache-resident buffer; time that case
+    // separately from streaming the whole 20+ MB capture out of DRAM
+    const int RECV_MSGS = 64;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NUM_ORDERS / RECV_MSGS; ++i) {
+        decoder.decode(wire.data(), RECV_MSGS * sizeof(OuchEnterOrder), sink);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> hot_ns = end - start;
+
+    auto wire_engine = std::make_unique<MatchingEngine<>>();
+    start = std::chrono::high_resolution_clock::now();
+    decoder.decode(wire.data(), wire.size(), *wire_engine);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> wire_ns = end - start;
+
+    std::cout << "--- OUCH Order Entry ---" << std::endl;
+    std::cout << "Bytes Decoded:    " << consumed << " (checksum " << sink.checksum << ")" << std::endl;
+    std::cout << "Decode Only:      " << decode_ns.count() / NUM_ORDERS << " ns/message (streamed)" << std::endl;
+    std::cout << "Decode Hot:       " << hot_ns.count() / (NUM_ORDERS / RECV_MSGS * RECV_MSGS) << " ns/message (recv-sized buffer)" << std::endl;
+    std::cout << "Decode + Match:   " << wire_ns.count() / NUM_ORDERS << " ns/message" << std::endl;
+
+
+    // --- FIX decode: the same orders as NewOrderSingle, prices at 2 decimals ---
+    std::string fix_wire;
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        uint32_t price = test_orders[i].price;
+        appendFix(fix_wire, "35=D\x01" "49=CLIENT\x01" "56=NANOMATCH\x01" "34=" + std::to_string(i + 1) +
+                            "\x01" "52=20240102-14:30:00.000\x01" "11=" + std::to_string(i) +
+                            "\x01" "55=XYZ\x01" "54=" + (test_orders[i].is_buy ? "1" : "2") +
+                            "\x01" "38=" + std::to_string(test_orders[i].qty) + "\x01" "40=2\x01" "44=" +
+                            std::to_string(price / 100) + "." + std::to_string(price % 100 / 10) +
+                            std::to_string(price % 10) + "\x01" "59=0\x01" "60=20240102-14:30:00.000\x01");
+    }
+
+    // ClOrdIDs are live per session, so each pass gets a fresh one
+    FixSessionConfig fix_config;
+    fix_config.max_orders = NUM_ORDERS;
+    DecodeSink fix_sink;
+    FixDecoder fix_decoder(fix_config);
+    start = std::chrono::high_resolution_clock::now();
+    size_t fix_consumed = fix_decoder.decode(fix_wire.data(), fix_wire.size(), fix_sink);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> fix_ns = end - start;
+
+    auto fix_engine = std::make_unique<MatchingEngine<>>();
+    FixDecoder fix_match_decoder(fix_config);
+    start = std::chrono::high_resolution_clock::now();
+    fix_match_decoder.decode(fix_wire.data(), fix_wire.size(), *fix_engine);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> fix_match_ns = end - start;
+
+    std::cout << "--- FIX Order Entry ---" << std::endl;
+    std::cout << "Bytes Decoded:    " << fix_consumed << " (checksum " << fix_sink.checksum
+              << ", rejected " << fix_decoder.rejected() << ")" << std::endl;
+    std::cout << "Decode Only:      " << fix_ns.count() / NUM_ORDERS << " ns/message" << std::endl;
+    std::cout << "Decode + Match:   " << fix_match_ns.count() / NUM_ORDERS << " ns/message" << std::endl;
+
+    // --- Depth snapshot: 10 levels a side spread across the whole ladder ---
+    constexpr size_t DEPTH = 10;
+    constexpr int SNAPSHOTS = 100000;
+    auto depth_engine = std::make_unique<MatchingEngine<>>();
+    for (uint32_t k = 0; k < DEPTH; ++k) {
+        depth_engine->processNewOrder(2 * k, 5100 + k * 450, 100, false);
+        depth_engine->processNewOrder(2 * k + 1, 4900 - k * 450, 100, true);
+    }
+    const OrderBook& depth_book = depth_engine->book(0);
+
+    DepthLevel bids[DEPTH];
+    DepthLevel asks[DEPTH];
+    uint64_t depth_checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SNAPSHOTS; ++i) {
+        size_t nb = depth_book.getDepth(true, DEPTH, bids);
+        size_t na = depth_book.getDepth(false, DEPTH, asks);
+        depth_checksum += bids[nb - 1].price + asks[na - 1].price;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> depth_ns = end - start;
+
+    // The same snapshot probing every slot of the ladder from the touch
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SNAPSHOTS; ++i) {
+        size_t nb = 0;
+        for (uint32_t p = MAX_PRICE_TICKS; p-- > 0 && nb < DEPTH;) {
+            const PriceLevel& level = depth_book.bids_[p];
+            if (level.order_count) bids[nb++] = DepthLevel{p, level.total_qty, level.order_count};
+        }
+        size_t na = 0;
+        for (uint32_t p = 0; p < MAX_PRICE_TICKS && na < DEPTH; ++p) {
+            const PriceLevel& level = depth_book.asks_[p];
+            if (level.order_count) asks[na++] = DepthLevel{p, level.total_qty, level.order_count};
+        }
+        depth_checksum += bids[nb - 1].price + asks[na - 1].price;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> scan_ns = end - start;
+
+    std::cout << "--- Depth Snapshot (" << DEPTH << " levels a side) ---" << std::endl;
+    std::cout << "Tracker Walk:     " << depth_ns.count() / SNAPSHOTS << " ns/snapshot (checksum "
+              << depth_checksum << ")" << std::endl;
+    std::cout << "Linear Scan:      " << scan_ns.count() / SNAPSHOTS << " ns/snapshot" << std::endl;
 
     return 0;
     } catch (const std::exception& e) {
@@ -0,0 +1,94 @@
+#ifndef BROADCASTRING_H
+#define BROADCASTRING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Disruptor-style single-producer multi-consumer broadcast ring.
+//
+// Every consumer sees every event, read in place from the ring: nothing is
+// copied per consumer. Each consumer owns a sequence (the next event it will
+// read) on its own cache line; the producer may only overwrite a slot once
+// the slowest consumer has moved past it. The producer caches that minimum
+// and rescans the consumer sequences only when the cache says it is full.
+template <typename T, size_t Capacity, size_t MaxConsumers>
+class BroadcastRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct alignas(64) ConsumerCursor {
+        std::atomic<uint64_t> sequence{0};     // Written by the consumer, read by the producer
+        alignas(64) uint64_t cached_published = 0; // Consumer's view of published_
+    };
+
+private:
+    alignas(64) std::atomic<uint64_t> published_{0}; // Events [0, published_) are readable
+    alignas(64) uint64_t cached_min_sequence_ = 0;     // Producer's view of the slowest consumer
+    size_t consumer_count_;
+    std::array<ConsumerCursor, MaxConsumers> consumers_;
+    alignas(64) std::array<T, Capacity> buffer_;
+
+    uint64_t slowestSequence() const {
+        uint64_t slowest = consumers_[0].sequence.load(std::memory_order_acquire);
+        for (size_t c = 1; c < consumer_count_; ++c) {
+            slowest = std::min(slowest, consumers_[c].sequence.load(std::memory_order_acquire));
+        }
+        return slowest;
+    }
+
+public:
+    explicit BroadcastRing(size_t consumers) : consumer_count_(consumers) {
+        if (consumers == 0 || consumers > MaxConsumers) throw std::runtime_error("BroadcastRing consumer count out of range");
+    }
+
+    size_t consumerCount() const { return consumer_count_; }
+
+    // --- Producer ---
+
+    // Next slot to fill in place, or nullptr while the slowest consumer is a
+    // full ring behind. At most one claim may be outstanding.
+    T* claim() {
+        const uint64_t next = published_.load(std::memory_order_relaxed);
+        if (next - cached_min_sequence_ >= Capacity) {
+            cached_min_sequence_ = slowestSequence();
+            if (next - cached_min_sequence_ >= Capacity) return nullptr;
+        }
+        return &buffer_[next & MASK];
+    }
+
+    // Make the claimed slot visible to every consumer
+    void publish() {
+        published_.store(published_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool push(const T& item) {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = item;
+        publish();
+        return true;
+    }
+
+    // --- Consumers ---
+
+    // Hand up to max_batch unread events to handler(const T&) in order, read
+    // in place, then release them with one store. Returns how many were read.
+    template <typename Handler>
+    size_t poll(size_t consumer, Handler&& handler, size_t max_batch = Capacity) {
+        ConsumerCursor& cursor = consumers_[consumer];
+        const uint64_t sequence = cursor.sequence.load(std::memory_order_relaxed);
+        if (cursor.cached_published == sequence) {
+            cursor.cached_published = published_.load(std::memory_order_acquire);
+        }
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(cursor.cached_published - sequence, max_batch));
+        for (size_t i = 0; i < n; ++i) handler(static_cast<const T&>(buffer_[(sequence + i) & MASK]));
+        if (n) cursor.sequence.store(sequence + n, std::memory_order_release);
+        return n;
+    }
+};
+
+#endif
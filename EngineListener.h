@@ -0,0 +1,88 @@
+#ifndef ENGINELISTENER_H
+#define ENGINELISTENER_H
+
+#include <cstdint>
+#include "OrderBook.h"
+#include "Types.h"
+
+enum class CancelReason : uint8_t {
+    Requested,  // Explicit processCancel
+    Replaced,   // Pulled for a price change / size increase; re-entry follows
+    Unfilled,   // IOC/FOK/market remainder dropped; the order never rested
+    Expired,    // GTD expire_time reached
+    SelfTrade,  // Self-trade prevention hit an order of the same owner
+};
+
+enum class RejectReason : uint8_t {
+    None,
+    DuplicateId,       // Id collides with a live resting order
+    InvalidPrice,      // Outside the [0, MAX_PRICE_TICKS) ladder
+    InvalidQuantity,   // Zero quantity on entry
+    UnknownOrder,      // Cancel/modify of an id that is not resting
+    WouldCross,        // Post-only order would have taken liquidity
+    NotFillable,       // FOK quantity not available up to its limit
+    InvalidExpiry,     // GTD expire_time not after the engine clock, or the clock not started
+    UnknownInstrument, // Instrument id outside the symbol directory
+};
+
+// Compile-time event listener policy for MatchingEngine.
+//
+// MatchingEngine<Listener> calls these hooks directly on its Listener member,
+// so they inline at the call sites with no virtual dispatch. A listener
+// derives from NullListener and hides only the hooks it cares about; the
+// rest stay empty and compile away. Orders passed in are only valid for the
+// duration of the call (they may be returned to the pool right after).
+struct NullListener {
+    // Order (or its remainder) rested on the book, or a stop was parked in
+    // the stop book (state == OrderState::Stopped)
+    void onAdd(const Order&) {}
+    // Parked stop elected by a trade; it now enters as a market/limit order
+    void onTrigger(const Order&) {}
+    // One fill; quantities on both orders are already reduced by qty
+    void onTrade(const Order& /*aggressor*/, const Order& /*resting*/, uint32_t /*price*/, uint32_t /*qty*/) {}
+    // Iceberg refilled its displayed slice from reserve and moved to the back
+    void onReplenish(const Order&) {}
+    // Order left the book (or stop book), or an aggressor's remainder was
+    // dropped (Unfilled)
+    void onCancel(const Order&, CancelReason) {}
+    // Open quantity reduced in place, queue priority kept
+    void onModify(const Order&, uint32_t /*old_qty*/) {}
+    // Request refused; the book is untouched
+    void onReject(uint64_t /*id*/, RejectReason) {}
+    // An operation that may have changed this instrument's book has
+    // finished; unlike the per-event hooks, the book is consistent here
+    void onBookUpdate(uint32_t /*instrument*/, const OrderBook&) {}
+};
+
+// Forwards every hook to two listeners, first then second, e.g. exec
+// reports and a market-data feed off the same engine. Still resolved at
+// compile time; nest pairs for more than two.
+template <typename First, typename Second>
+class TeeListener {
+private:
+    First first_;
+    Second second_;
+
+public:
+    TeeListener(const First& first, const Second& second) : first_(first), second_(second) {}
+
+    First& first() { return first_; }
+    Second& second() { return second_; }
+
+    void onAdd(const Order& order) { first_.onAdd(order); second_.onAdd(order); }
+    void onTrigger(const Order& order) { first_.onTrigger(order); second_.onTrigger(order); }
+    void onTrade(const Order& aggressor, const Order& resting, uint32_t price, uint32_t qty) {
+        first_.onTrade(aggressor, resting, price, qty);
+        second_.onTrade(aggressor, resting, price, qty);
+    }
+    void onReplenish(const Order& order) { first_.onReplenish(order); second_.onReplenish(order); }
+    void onCancel(const Order& order, CancelReason reason) { first_.onCancel(order, reason); second_.onCancel(order, reason); }
+    void onModify(const Order& order, uint32_t old_qty) { first_.onModify(order, old_qty); second_.onModify(order, old_qty); }
+    void onReject(uint64_t id, RejectReason reason) { first_.onReject(id, reason); second_.onReject(id, reason); }
+    void onBookUpdate(uint32_t instrument, const OrderBook& book) {
+        first_.onBookUpdate(instrument, book);
+        second_.onBookUpdate(instrument, book);
+    }
+};
+
+#endif
\ No newline at end of file
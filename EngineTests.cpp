@@ -0,0 +1,601 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "ExecReport.h"
+#include "FixProtocol.h"
+#include "Journal.h"
+#include "MatchPolicy.h"
+#include "MatchingEngine.h"
+#include "OuchProtocol.h"
+
+// Scenario tests: small, hand-built books driven through the public API,
+// checked against the events the engine reports. Build and run like the
+// benchmarks; the exit code is the number of failed checks.
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                      \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            std::cout << "FAIL " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            ++failures;                                                                  \
+        }                                                                                \
+    } while (0)
+
+// Records what the tests assert on; everything else stays a NullListener hook
+struct RecordingListener : NullListener {
+    struct Trade {
+        uint64_t aggressor;
+        uint64_t resting;
+        uint32_t price;
+        uint32_t qty;
+        bool operator==(const Trade& o) const {
+            return aggressor == o.aggressor && resting == o.resting && price == o.price && qty == o.qty;
+        }
+    };
+    struct Reject {
+        uint64_t id;
+        RejectReason reason;
+    };
+    struct Cancel {
+        uint64_t id;
+        CancelReason reason;
+        bool operator==(const Cancel& o) const { return id == o.id && reason == o.reason; }
+    };
+    struct Modify {
+        uint64_t id;
+        uint32_t old_qty;
+        uint32_t qty;  // Open qty afterwards, displayed plus reserve
+        bool operator==(const Modify& o) const { return id == o.id && old_qty == o.old_qty && qty == o.qty; }
+    };
+
+    std::vector<Trade> trades;
+    std::vector<Reject> rejects;
+    std::vector<Cancel> cancels;
+    std::vector<Modify> modifies;
+    std::vector<uint64_t> triggers;
+    std::vector<uint64_t> replenishes;
+
+    void onTrigger(const Order& order) { triggers.push_back(order.id); }
+    void onTrade(const Order& aggressor, const Order& resting, uint32_t price, uint32_t qty) {
+        trades.push_back(Trade{aggressor.id, resting.id, price, qty});
+    }
+    void onReplenish(const Order& order) { replenishes.push_back(order.id); }
+    void onCancel(const Order& order, CancelReason reason) { cancels.push_back(Cancel{order.id, reason}); }
+    void onModify(const Order& order, uint32_t old_qty) {
+        modifies.push_back(Modify{order.id, old_qty, order.qty + order.reserve_qty});
+    }
+    void onReject(uint64_t id, RejectReason reason) { rejects.push_back(Reject{id, reason}); }
+};
+
+using Trades = std::vector<RecordingListener::Trade>;
+using Cancels = std::vector<RecordingListener::Cancel>;
+
+// A level's aggregates, as depth snapshots read them
+static bool levelIs(const PriceLevel& level, uint64_t total_qty, uint32_t order_count, uint64_t hidden_qty = 0) {
+    return level.total_qty == total_qty && level.order_count == order_count && level.hidden_qty == hidden_qty;
+}
+
+using TestEngine = MatchingEngine<RecordingListener>;
+
+// A post-only bid repriced through the best ask must be refused, not traded
+static void testPostOnlyModifyWouldCross() {
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+
+    engine->processNewOrder(1, 100, 10, false);
+    engine->processNewOrder(2, 99, 10, true, OrderType::PostOnly);
+    CHECK(!engine->processModify(2, 100, 10));
+
+    CHECK(events.trades.empty());
+    CHECK(events.rejects.size() == 1 && events.rejects[0].id == 2 &&
+          events.rejects[0].reason == RejectReason::WouldCross);
+    // Both orders rest untouched, the bid at its old price
+    const OrderBook& book = engine->book();
+    CHECK(book.bids_[99].order_count == 1 && book.bids_[99].total_qty == 10);
+    CHECK(book.asks_[100].order_count == 1 && book.asks_[100].total_qty == 10);
+
+    // A non-crossing reprice still goes through
+    CHECK(engine->processModify(2, 98, 10));
+    CHECK(book.bids_[98].order_count == 1 && book.bids_[99].order_count == 0);
+    CHECK(events.trades.empty());
+}
+
+// A GTD order sent before the first advanceTime used to be scheduled on a
+// wheel still at tick 0 and clamped to its horizon; it must be refused
+static void testGtdBeforeClockStart() {
+    const uint64_t T0 = 1704205800ULL * 1000000000ULL; // Epoch-ns engine clock
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+
+    CHECK(!engine->processNewOrder(1, 100, 10, true, OrderType::Limit, TimeInForce::GTD, 0, 0, T0 + 5000000000ULL));
+    CHECK(events.rejects.size() == 1 && events.rejects[0].id == 1 &&
+          events.rejects[0].reason == RejectReason::InvalidExpiry);
+    CHECK(engine->book().bids_[100].order_count == 0);
+
+    // Once the clock runs, the same order expires on time
+    engine->advanceTime(T0);
+    CHECK(engine->processNewOrder(1, 100, 10, true, OrderType::Limit, TimeInForce::GTD, 0, 0, T0 + 5000000000ULL));
+    engine->advanceTime(T0 + 4000000000ULL);
+    CHECK(engine->book().bids_[100].order_count == 1);
+    engine->advanceTime(T0 + 5000000000ULL + (1ULL << TimingWheel::TICK_SHIFT));
+    CHECK(engine->book().bids_[100].order_count == 0);
+    CHECK(events.cancels.size() == 1 && events.cancels[0].id == 1 &&
+          events.cancels[0].reason == CancelReason::Expired);
+}
+
+// Reports off a multi-instrument engine must say which book they belong to,
+// on the ring and on the OUCH wire
+static void testExecReportsCarryInstrument() {
+    auto reports = std::make_unique<ReportQueue>();
+    SymbolConfig symbols;
+    symbols.instruments = 2;
+    auto engine = std::make_unique<MatchingEngine<ExecReportListener>>(symbols, ExecReportListener(reports.get()));
+
+    engine->processNewOrder(1, 100, 10, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 0, StpMode::None, 1);
+    engine->processNewOrder(2, 100, 4, true, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 0, StpMode::None, 1);
+    engine->processCancel(99);
+
+    ExecReport added, filled, rejected;
+    CHECK(reports->pop(added) && added.type == ExecType::Added && added.instrument == 1);
+    CHECK(reports->pop(filled) && filled.type == ExecType::Filled && filled.instrument == 1);
+    CHECK(reports->pop(rejected) && rejected.type == ExecType::Rejected && rejected.instrument == ALL_INSTRUMENTS);
+
+    char wire[OUCH_MAX_REPORT_BYTES] = {};
+    CHECK(encodeOuchReport(filled, wire) == 2 * sizeof(OuchExecuted));
+    OuchExecuted taker, maker;
+    std::memcpy(&taker, wire, sizeof(taker));
+    std::memcpy(&maker, wire + sizeof(taker), sizeof(maker));
+    CHECK(taker.order_id == 2 && taker.instrument == 1 && maker.order_id == 1 && maker.instrument == 1);
+}
+
+// A trade through a parked stop elects it, and its own fill elects the next:
+// one aggressor walks the whole ladder, the last stop finding nothing left
+static void testStopCascade() {
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    const OrderBook& book = engine->book();
+
+    engine->processNewOrder(1, 101, 10, false);
+    engine->processNewOrder(2, 102, 10, false);
+    engine->processNewOrder(3, 103, 10, false);
+    // Nothing has traded yet, so all three park
+    CHECK(engine->processNewOrder(10, 0, 10, true, OrderType::Stop, TimeInForce::GTC, 0, 101));
+    CHECK(engine->processNewOrder(11, 0, 10, true, OrderType::Stop, TimeInForce::GTC, 0, 102));
+    CHECK(engine->processNewOrder(12, 0, 5, true, OrderType::Stop, TimeInForce::GTC, 0, 103));
+    CHECK(events.trades.empty() && events.triggers.empty());
+
+    engine->processNewOrder(20, 101, 10, true);
+    CHECK(events.trades == (Trades{{20, 1, 101, 10}, {10, 2, 102, 10}, {11, 3, 103, 10}}));
+    CHECK(events.triggers == (std::vector<uint64_t>{10, 11, 12}));
+    CHECK(events.cancels == (Cancels{{12, CancelReason::Unfilled}}));
+    CHECK(levelIs(book.asks_[101], 0, 0) && levelIs(book.asks_[102], 0, 0) && levelIs(book.asks_[103], 0, 0));
+    CHECK(book.ask_tracker_.isEmpty() && book.bid_tracker_.isEmpty());
+    // Elected stops are off the index: nothing left to cancel
+    CHECK(!engine->processCancel(10) && !engine->processCancel(12));
+}
+
+// Owner 7 rests 10 at the head of the level, owner 8 another 5 behind it;
+// owner 7 then buys 8 into it under each STP mode
+static std::unique_ptr<TestEngine> selfTradeBook() {
+    auto engine = std::make_unique<TestEngine>();
+    engine->processNewOrder(1, 100, 10, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 7);
+    engine->processNewOrder(2, 100, 5, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 8);
+    return engine;
+}
+
+static void buyAsOwner7(TestEngine& engine, StpMode stp) {
+    engine.processNewOrder(3, 100, 8, true, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 7, stp);
+}
+
+static void testSelfTradePrevention() {
+    {
+        // CancelResting: own order pulled, matching carries on behind it
+        auto engine = selfTradeBook();
+        buyAsOwner7(*engine, StpMode::CancelResting);
+        RecordingListener& events = engine->listener();
+        CHECK(events.cancels == (Cancels{{1, CancelReason::SelfTrade}}));
+        CHECK(events.trades == (Trades{{3, 2, 100, 5}}));
+        CHECK(levelIs(engine->book().asks_[100], 0, 0));
+        CHECK(levelIs(engine->book().bids_[100], 3, 1));
+    }
+    {
+        // CancelAggressor: nothing trades and the book is untouched
+        auto engine = selfTradeBook();
+        buyAsOwner7(*engine, StpMode::CancelAggressor);
+        RecordingListener& events = engine->listener();
+        CHECK(events.cancels == (Cancels{{3, CancelReason::SelfTrade}}));
+        CHECK(events.trades.empty());
+        CHECK(levelIs(engine->book().asks_[100], 15, 2));
+        CHECK(levelIs(engine->book().bids_[100], 0, 0));
+    }
+    {
+        // CancelBoth: resting first, then the aggressor
+        auto engine = selfTradeBook();
+        buyAsOwner7(*engine, StpMode::CancelBoth);
+        RecordingListener& events = engine->listener();
+        CHECK(events.cancels == (Cancels{{1, CancelReason::SelfTrade}, {3, CancelReason::SelfTrade}}));
+        CHECK(events.trades.empty());
+        CHECK(levelIs(engine->book().asks_[100], 5, 1));
+        CHECK(levelIs(engine->book().bids_[100], 0, 0));
+    }
+    {
+        // DecrementAndCancel: both lose 8; the resting order keeps 2 and
+        // its place at the head, the aggressor is used up
+        auto engine = selfTradeBook();
+        buyAsOwner7(*engine, StpMode::DecrementAndCancel);
+        RecordingListener& events = engine->listener();
+        CHECK(events.modifies == (std::vector<RecordingListener::Modify>{{1, 10, 2}}));
+        CHECK(events.cancels == (Cancels{{3, CancelReason::SelfTrade}}));
+        CHECK(events.trades.empty());
+        CHECK(levelIs(engine->book().asks_[100], 7, 2));
+        CHECK(engine->book().asks_[100].head->id == 1);
+        CHECK(levelIs(engine->book().bids_[100], 0, 0));
+    }
+}
+
+// Shares are floor(qty * order / level) off the level's aggregate, and the
+// rounding remainder goes FIFO from the head
+static void testProRataAllocation() {
+    auto engine = std::make_unique<MatchingEngine<RecordingListener, ProRataMatch>>();
+    RecordingListener& events = engine->listener();
+    const PriceLevel& level = engine->book().asks_[100];
+    engine->processNewOrder(1, 100, 10, false);
+    engine->processNewOrder(2, 100, 30, false);
+    engine->processNewOrder(3, 100, 60, false);
+
+    engine->processNewOrder(10, 100, 50, true);
+    CHECK(events.trades == (Trades{{10, 1, 100, 5}, {10, 2, 100, 15}, {10, 3, 100, 30}}));
+    CHECK(levelIs(level, 50, 3));
+
+    // 7 over 5/15/30: 0, 2 and 4, and the odd lot to the head
+    engine->processNewOrder(11, 100, 7, true);
+    CHECK(events.trades == (Trades{{10, 1, 100, 5}, {10, 2, 100, 15}, {10, 3, 100, 30},
+                                   {11, 2, 100, 2}, {11, 3, 100, 4}, {11, 1, 100, 1}}));
+    CHECK(levelIs(level, 43, 3));
+}
+
+// The order that opened the level takes up to top_order_cap first; the
+// rest is pro-rata over what is left, remainder FIFO
+static void testTopOrderAllocation() {
+    ProRataTopOrderMatch policy;
+    policy.top_order_cap = 5;
+    auto engine = std::make_unique<MatchingEngine<RecordingListener, ProRataTopOrderMatch>>(RecordingListener(), policy);
+    RecordingListener& events = engine->listener();
+    engine->processNewOrder(1, 100, 20, false);
+    engine->processNewOrder(2, 100, 30, false);
+    engine->processNewOrder(3, 100, 50, false);
+
+    // 5 to the top order, then 20 over 15/30/50 of 95: 3, 6, 10 and 1 over
+    engine->processNewOrder(10, 100, 25, true);
+    CHECK(events.trades == (Trades{{10, 1, 100, 5}, {10, 1, 100, 3}, {10, 2, 100, 6},
+                                   {10, 3, 100, 10}, {10, 1, 100, 1}}));
+    CHECK(levelIs(engine->book().asks_[100], 75, 3));
+}
+
+// The lead market maker is offered lmm_percent of the arriving qty ahead of
+// the queue; the rest fills FIFO, the LMM included
+static void testLmmAllocation() {
+    auto engine = std::make_unique<MatchingEngine<RecordingListener, FifoLmmMatch>>(RecordingListener(), FifoLmmMatch{9, 40});
+    RecordingListener& events = engine->listener();
+    engine->processNewOrder(1, 100, 10, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 1);
+    engine->processNewOrder(2, 100, 10, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 9);
+    engine->processNewOrder(3, 100, 10, false, OrderType::Limit, TimeInForce::GTC, 0, 0, 0, 2);
+
+    engine->processNewOrder(10, 100, 20, true);
+    CHECK(events.trades == (Trades{{10, 2, 100, 8}, {10, 1, 100, 10}, {10, 2, 100, 2}}));
+    CHECK(levelIs(engine->book().asks_[100], 10, 1));
+    CHECK(engine->book().asks_[100].head->id == 3);
+}
+
+// A refilled iceberg slice goes to the back of the level, behind orders
+// that arrived after the iceberg itself
+static void testIcebergReplenishPriority() {
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    const PriceLevel& level = engine->book().asks_[100];
+    engine->processNewOrder(1, 100, 30, false, OrderType::Limit, TimeInForce::GTC, 10);
+    engine->processNewOrder(2, 100, 10, false);
+    CHECK(levelIs(level, 20, 2, 20));
+
+    engine->processNewOrder(10, 100, 15, true);
+    CHECK(events.trades == (Trades{{10, 1, 100, 10}, {10, 2, 100, 5}}));
+    CHECK(events.replenishes == (std::vector<uint64_t>{1}));
+    CHECK(levelIs(level, 15, 2, 10));
+
+    engine->processNewOrder(11, 100, 10, true);
+    CHECK(events.trades == (Trades{{10, 1, 100, 10}, {10, 2, 100, 5}, {11, 2, 100, 5}, {11, 1, 100, 5}}));
+    CHECK(levelIs(level, 5, 1, 10));
+    CHECK(events.cancels.empty());
+}
+
+// Shrinking an order keeps its place; growing it re-queues it at the back
+static void testModifyQueuePriority() {
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    const PriceLevel& level = engine->book().bids_[100];
+    engine->processNewOrder(1, 100, 10, true);
+    engine->processNewOrder(2, 100, 10, true);
+    engine->processNewOrder(3, 100, 10, true);
+
+    CHECK(engine->processModify(1, 100, 6));
+    CHECK(events.modifies == (std::vector<RecordingListener::Modify>{{1, 10, 6}}));
+    CHECK(engine->processModify(2, 100, 15));
+    CHECK(engine->processCancel(3));
+    CHECK(events.cancels == (Cancels{{2, CancelReason::Replaced}, {3, CancelReason::Requested}}));
+    CHECK(levelIs(level, 21, 2));
+
+    // Queue is now 1 (6), 2 (15)
+    engine->processNewOrder(10, 100, 10, false);
+    CHECK(events.trades == (Trades{{10, 1, 100, 6}, {10, 2, 100, 4}}));
+    CHECK(levelIs(level, 11, 1));
+    CHECK(!engine->processCancel(1));
+}
+
+// IOC and market remainders are dropped as Unfilled and never rest; an FOK
+// either fills whole or is refused with the book untouched
+static void testUnfilledRemainders() {
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    const OrderBook& book = engine->book();
+    engine->processNewOrder(1, 100, 10, false);
+    engine->processNewOrder(2, 101, 10, false);
+
+    CHECK(engine->processNewOrder(10, 100, 15, true, OrderType::Limit, TimeInForce::IOC));
+    CHECK(events.trades == (Trades{{10, 1, 100, 10}}));
+    CHECK(events.cancels == (Cancels{{10, CancelReason::Unfilled}}));
+    CHECK(levelIs(book.bids_[100], 0, 0) && book.bid_tracker_.isEmpty());
+
+    CHECK(!engine->processNewOrder(11, 101, 15, true, OrderType::Limit, TimeInForce::FOK));
+    CHECK(events.rejects.size() == 1 && events.rejects[0].id == 11 &&
+          events.rejects[0].reason == RejectReason::NotFillable);
+    CHECK(events.trades.size() == 1 && levelIs(book.asks_[101], 10, 1));
+
+    CHECK(engine->processNewOrder(12, 101, 10, true, OrderType::Limit, TimeInForce::FOK));
+    CHECK(events.trades == (Trades{{10, 1, 100, 10}, {12, 2, 101, 10}}));
+    CHECK(levelIs(book.asks_[101], 0, 0));
+
+    engine->processNewOrder(3, 102, 5, false);
+    CHECK(engine->processNewOrder(13, 0, 8, true, OrderType::Market));
+    CHECK(events.trades == (Trades{{10, 1, 100, 10}, {12, 2, 101, 10}, {13, 3, 102, 5}}));
+    CHECK(events.cancels == (Cancels{{10, CancelReason::Unfilled}, {13, CancelReason::Unfilled}}));
+    CHECK(book.ask_tracker_.isEmpty() && book.bid_tracker_.isEmpty());
+}
+
+// Orders journaled in processing order and replayed into a fresh engine,
+// with the clock advanced as the timestamps move, rebuild the same book. A
+// reopened journal resumes after its last record.
+static void testJournalReplay() {
+    const std::string path = "/tmp/nanomatch-tests-" + std::to_string(getpid()) + ".journal";
+    unlink(path.c_str());
+    const uint64_t T0 = 1704205800ULL * 1000000000ULL;
+
+    std::vector<std::pair<RawOrder, uint64_t>> day;
+    day.reserve(7); // order() hands out pointers into it
+    auto order = [&](uint64_t id, uint32_t price, uint32_t qty, bool is_buy, uint64_t at) {
+        RawOrder raw{id, price, qty, is_buy};
+        day.push_back({raw, at});
+        return &day.back().first;
+    };
+    order(1, 100, 10, false, T0);
+    order(2, 101, 30, false, T0)->display_qty = 10;
+    order(3, 99, 20, true, T0);
+    RawOrder* gtd = order(4, 98, 5, true, T0);
+    gtd->tif = TimeInForce::GTD;
+    gtd->expire_time = T0 + 1000000000ULL;
+    order(5, 101, 25, true, T0 + 500000000ULL);
+    order(6, 99, 12, false, T0 + 2000000000ULL);
+    RawOrder* stop = order(7, 0, 3, false, T0 + 2000000000ULL);
+    stop->type = OrderType::Stop;
+    stop->stop_price = 99;
+
+    // Run the day through a journal, as the matching thread does
+    auto journaled = std::make_unique<TestEngine>();
+    auto queue = std::make_unique<JournalQueue<RawOrder>>();
+    JournalConfig config;
+    config.initial_bytes = 0; // Smallest file the writer allows
+    {
+        JournalWriter<RawOrder> journal(queue.get(), path, config);
+        JournalSequencer<RawOrder> sequencer(queue.get(), journal.nextSequence());
+        uint64_t clock = 0;
+        for (size_t i = 0; i + 1 < day.size(); ++i) {
+            if (day[i].second != clock) journaled->advanceTime(clock = day[i].second);
+            sequencer.append(day[i].first, clock);
+            journaled->processNewOrder(day[i].first);
+        }
+        CHECK(journal.poll() == day.size() - 1);
+        journal.sync();
+    }
+
+    // Reopened, it resumes at the next sequence
+    {
+        JournalWriter<RawOrder> journal(queue.get(), path, config);
+        CHECK(journal.nextSequence() == day.size());
+        JournalSequencer<RawOrder> sequencer(queue.get(), journal.nextSequence());
+        sequencer.append(day.back().first, day.back().second);
+        journaled->processNewOrder(day.back().first);
+        CHECK(journal.poll() == 1);
+        journal.sync();
+    }
+
+    auto replayed = std::make_unique<TestEngine>();
+    uint64_t clock = 0;
+    uint64_t expected = 1;
+    bool in_order = true;
+    const uint64_t n = replayJournal<RawOrder>(path, [&](const JournalRecord<RawOrder>& record) {
+        in_order &= (record.sequence == expected++ && record.message.id == record.sequence);
+        if (record.timestamp != clock) replayed->advanceTime(clock = record.timestamp);
+        replayed->processNewOrder(record.message);
+    });
+    unlink(path.c_str());
+    CHECK(n == day.size() && in_order);
+
+    // 5 took 1 and a refilled iceberg slice, 4 expired, 6 printed at 99 and
+    // elected the sell stop behind it
+    const RecordingListener& a = journaled->listener();
+    const RecordingListener& b = replayed->listener();
+    CHECK(a.trades == (Trades{{5, 1, 100, 10}, {5, 2, 101, 10}, {5, 2, 101, 5}, {6, 3, 99, 12}, {7, 3, 99, 3}}));
+    CHECK(b.trades == a.trades);
+    CHECK(a.cancels == (Cancels{{4, CancelReason::Expired}}));
+    CHECK(b.cancels == a.cancels && b.replenishes == a.replenishes && b.triggers == a.triggers);
+    for (uint32_t price : {98u, 99u, 100u, 101u}) {
+        const PriceLevel& x = journaled->book().bids_[price];
+        const PriceLevel& y = journaled->book().asks_[price];
+        CHECK(levelIs(replayed->book().bids_[price], x.total_qty, x.order_count, x.hidden_qty));
+        CHECK(levelIs(replayed->book().asks_[price], y.total_qty, y.order_count, y.hidden_qty));
+    }
+    CHECK(levelIs(replayed->book().bids_[99], 5, 1) && levelIs(replayed->book().asks_[101], 5, 1, 10));
+}
+
+// Frame one FIX 4.4 message around body (tag=value fields, each ending in SOH)
+static std::string fixMessage(const std::string& body) {
+    std::string out = "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+    unsigned sum = 0;
+    for (char c : out) sum += static_cast<uint8_t>(c);
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", sum % 256);
+    return out + trailer;
+}
+
+static std::string fixGtdOrder(uint64_t id, const std::string& expire_time) {
+    return fixMessage("35=D\x01" "11=" + std::to_string(id) + "\x01" "55=XYZ\x01" "54=1\x01" "38=10\x01"
+                      "40=2\x01" "44=1.00\x01" "59=6\x01" "126=" + expire_time + "\x01");
+}
+
+// 126 ExpireTime is UTC; with the session's clock offset it must expire on
+// the engine clock, not be taken as an engine timestamp as is
+static void testFixGtdExpiresOnEngineClock() {
+    const uint64_t EXPIRE_UTC_NS = 1704205800ULL * 1000000000ULL; // 2024-01-02 14:30:00 UTC
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    engine->advanceTime(1000000000);
+
+    // Engine clock reads 1 s when UTC reads 14:29:59
+    FixSessionConfig config;
+    config.clock_offset_ns = 1000000000 - static_cast<int64_t>(EXPIRE_UTC_NS - 1000000000);
+    FixDecoder decoder(config);
+    std::string wire = fixGtdOrder(7, "20240102-14:30:00.000");
+    CHECK(decoder.decode(wire.data(), wire.size(), *engine) == wire.size());
+    CHECK(decoder.rejected() == 0 && events.rejects.empty());
+    CHECK(engine->book().bids_[100].order_count == 1);
+
+    engine->advanceTime(1999999999);
+    CHECK(engine->book().bids_[100].order_count == 1);
+    // The wheel fires up to one tick late, never early
+    engine->advanceTime(2000000000 + (1ULL << TimingWheel::TICK_SHIFT));
+    uint64_t id = 0;
+    CHECK(decoder.orders().find("7", id));
+    CHECK(engine->book().bids_[100].order_count == 0);
+    CHECK(events.cancels.size() == 1 && events.cancels[0].id == id &&
+          events.cancels[0].reason == CancelReason::Expired);
+
+    // An ExpireTime already behind the engine clock is refused
+    wire = fixGtdOrder(8, "20240102-14:29:59.500");
+    decoder.decode(wire.data(), wire.size(), *engine);
+    CHECK(events.rejects.size() == 1 && events.rejects[0].id == id + 1 &&
+          events.rejects[0].reason == RejectReason::InvalidExpiry);
+}
+
+// 38 on a replace is the total OrderQty: the engine must get OrderQty less
+// CumQty, and the order must answer to its new ClOrdID afterwards
+static void testFixReplaceTracksCumQtyAndClOrdId() {
+    FixDecoder decoder;
+    using FixEngine = MatchingEngine<TeeListener<RecordingListener, FixSessionListener>>;
+    auto engine = std::make_unique<FixEngine>(
+        TeeListener<RecordingListener, FixSessionListener>(RecordingListener(), FixSessionListener(&decoder)));
+    RecordingListener& events = engine->listener().first();
+    const OrderBook& book = engine->book();
+
+    std::string wire = fixMessage("35=D\x01" "11=ABC-1\x01" "55=XYZ\x01" "54=1\x01" "38=100\x01"
+                                  "40=2\x01" "44=1.00\x01");
+    decoder.decode(wire.data(), wire.size(), *engine);
+    uint64_t id = 0;
+    CHECK(decoder.rejected() == 0 && decoder.orders().find("ABC-1", id));
+
+    // A 30 lot fills against it
+    engine->processNewOrder(1000, 100, 30, false);
+    CHECK(events.trades.size() == 1 && events.trades[0].resting == id && events.trades[0].qty == 30);
+    CHECK(decoder.orders().cumQty(id) == 30);
+    CHECK(book.bids_[100].total_qty == 70);
+
+    // OrderQty 100 -> 120 leaves 90 open, not 120
+    wire = fixMessage("35=G\x01" "41=ABC-1\x01" "11=ABC-2\x01" "55=XYZ\x01" "54=1\x01" "38=120\x01"
+                      "40=2\x01" "44=1.00\x01");
+    decoder.decode(wire.data(), wire.size(), *engine);
+    CHECK(decoder.rejected() == 0);
+    CHECK(book.bids_[100].order_count == 1 && book.bids_[100].total_qty == 90);
+    CHECK(decoder.orders().orderQty(id) == 120 && decoder.orders().clOrdId(id) == "ABC-2");
+
+    // The old ClOrdID is gone; the new one addresses the order
+    wire = fixMessage("35=F\x01" "41=ABC-1\x01" "11=ABC-3\x01" "55=XYZ\x01" "54=1\x01");
+    decoder.decode(wire.data(), wire.size(), *engine);
+    CHECK(decoder.rejected() == 1 && book.bids_[100].order_count == 1);
+
+    // Replacing down to the filled quantity leaves nothing open: a cancel
+    wire = fixMessage("35=G\x01" "41=ABC-2\x01" "11=ABC-3\x01" "55=XYZ\x01" "54=1\x01" "38=30\x01"
+                      "40=2\x01" "44=1.00\x01");
+    decoder.decode(wire.data(), wire.size(), *engine);
+    CHECK(decoder.rejected() == 1 && book.bids_[100].order_count == 0);
+    CHECK(events.cancels.size() == 2 && events.cancels[0].reason == CancelReason::Replaced &&
+          events.cancels[1].id == id && events.cancels[1].reason == CancelReason::Requested);
+}
+
+// The same through fixSteadyClockOffsetNs(), with the engine on steady_clock
+static void testFixGtdExpiresOnSteadyClock() {
+    auto steadyNs = []() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    auto engine = std::make_unique<TestEngine>();
+    RecordingListener& events = engine->listener();
+    const uint64_t start = steadyNs();
+    engine->advanceTime(start);
+
+    FixSessionConfig config;
+    config.clock_offset_ns = fixSteadyClockOffsetNs();
+    FixDecoder decoder(config);
+
+    // Expire two seconds from now, whole seconds of UTC
+    std::time_t expire = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()) + 2;
+    std::tm utc;
+    gmtime_r(&expire, &utc);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H:%M:%S", &utc);
+    std::string wire = fixGtdOrder(9, stamp);
+    decoder.decode(wire.data(), wire.size(), *engine);
+    CHECK(events.rejects.empty() && engine->book().bids_[100].order_count == 1);
+
+    engine->advanceTime(start + 500000000);
+    CHECK(engine->book().bids_[100].order_count == 1);
+    engine->advanceTime(start + 3000000000ULL);
+    CHECK(engine->book().bids_[100].order_count == 0);
+    CHECK(events.cancels.size() == 1 && events.cancels[0].reason == CancelReason::Expired);
+}
+
+int main() {
+    testPostOnlyModifyWouldCross();
+    testGtdBeforeClockStart();
+    testExecReportsCarryInstrument();
+    testStopCascade();
+    testSelfTradePrevention();
+    testProRataAllocation();
+    testTopOrderAllocation();
+    testLmmAllocation();
+    testIcebergReplenishPriority();
+    testModifyQueuePriority();
+    testUnfilledRemainders();
+    testJournalReplay();
+    testFixGtdExpiresOnEngineClock();
+    testFixReplaceTracksCumQtyAndClOrdId();
+    testFixGtdExpiresOnSteadyClock();
+
+    if (failures == 0) std::cout << "All scenario tests passed" << std::endl;
+    return failures;
+}
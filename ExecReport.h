@@ -0,0 +1,92 @@
+#ifndef EXECREPORT_H
+#define EXECREPORT_H
+
+#include <cstdint>
+#include <type_traits>
+#include "BroadcastRing.h"
+#include "EngineListener.h"
+#include "SpscQueue.h"
+#include "SymbolDirectory.h"
+
+enum class ExecType : uint8_t {
+    Added,      // Order (or its remainder) rested on the book - doubles as the ack
+    Filled,     // One trade; order_id is the aggressor, contra_id the resting maker
+    Cancelled,  // Order left the book, see reason
+    Modified,   // Open quantity reduced in place, queue priority kept
+    Rejected,   // Request refused, see reject_reason
+    Triggered,  // Parked stop elected; fills/adds for it follow
+};
+
+// Fixed-size outbound record. Written by the matching thread with a single
+// store into a preallocated ring and drained by a publisher thread.
+struct ExecReport {
+    uint64_t order_id;
+    uint64_t contra_id;          // Maker id on fills, 0 otherwise
+    uint32_t price;
+    uint32_t qty;                // Traded qty on fills, open qty otherwise
+    uint32_t leaves_qty;         // Aggressor's open qty after a fill
+    uint32_t contra_leaves_qty;  // Maker's open qty (incl. iceberg reserve) after a fill
+    uint32_t instrument;         // Book of order_id; ALL_INSTRUMENTS on rejects, which name none
+    ExecType type;
+    CancelReason reason;
+    RejectReason reject_reason;
+    bool is_buy;                 // Side of order_id
+};
+
+static_assert(std::is_trivially_copyable<ExecReport>::value, "ExecReport must stay POD");
+
+constexpr size_t REPORT_QUEUE_CAPACITY = 65536;
+constexpr size_t MAX_REPORT_CONSUMERS = 8;
+using ReportQueue = SpscQueue<ExecReport, REPORT_QUEUE_CAPACITY>;
+// Fan-out to several downstream consumers (market data, drop copy, risk...)
+// that all read the same records in place
+using ReportBroadcast = BroadcastRing<ExecReport, REPORT_QUEUE_CAPACITY, MAX_REPORT_CONSUMERS>;
+
+// Listener that turns engine events into ExecReports on an outbound ring
+// (ReportQueue or ReportBroadcast). The ring is drained by publisher
+// threads; the matching thread only spins if they fall a full ring behind.
+template <typename Ring>
+class BasicExecReportListener : public NullListener {
+private:
+    Ring* reports_;
+
+    void publish(const ExecReport& record) {
+        while (!reports_->push(record)) {
+            // Backpressure: the publisher is a full ring behind
+        }
+    }
+
+    void report(const Order& order, ExecType type, CancelReason reason = CancelReason::Requested) {
+        uint32_t open_qty = order.qty + order.reserve_qty;
+        publish(ExecReport{order.id, 0, order.price, open_qty, open_qty, 0, order.instrument,
+                           type, reason, RejectReason::None, order.is_buy});
+    }
+
+public:
+    explicit BasicExecReportListener(Ring* reports) : reports_(reports) {}
+
+    void onAdd(const Order& order) { report(order, ExecType::Added); }
+
+    void onTrade(const Order& aggressor, const Order& resting, uint32_t price, uint32_t qty) {
+        publish(ExecReport{aggressor.id, resting.id, price, qty, aggressor.qty,
+                           resting.qty + resting.reserve_qty, aggressor.instrument,
+                           ExecType::Filled, CancelReason::Requested, RejectReason::None,
+                           aggressor.is_buy});
+    }
+
+    void onTrigger(const Order& order) { report(order, ExecType::Triggered); }
+
+    void onCancel(const Order& order, CancelReason reason) { report(order, ExecType::Cancelled, reason); }
+
+    void onModify(const Order& order, uint32_t) { report(order, ExecType::Modified); }
+
+    void onReject(uint64_t id, RejectReason reason) {
+        publish(ExecReport{id, 0, 0, 0, 0, 0, ALL_INSTRUMENTS, ExecType::Rejected, CancelReason::Requested,
+                           reason, false});
+    }
+};
+
+using ExecReportListener = BasicExecReportListener<ReportQueue>;
+using BroadcastReportListener = BasicExecReportListener<ReportBroadcast>;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,759 @@
+#ifndef FIXPROTOCOL_H
+#define FIXPROTOCOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "EngineListener.h"
+#include "SymbolDirectory.h"
+#include "Types.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// FIX 4.2/4.4 tag=value decoder for the three order-entry messages:
+// NewOrderSingle (35=D), OrderCancelRequest (35=F) and
+// OrderCancelReplaceRequest (35=G).
+//
+// A message is framed from BeginString (8), BodyLength (9) and the trailing
+// CheckSum (10). The body is then scanned a vector at a time: compares
+// against SOH and '=' give bitmasks of both delimiters in 32 bytes (AVX2)
+// or 16 (SSE2), and the fields fall out of walking the set bits.
+// Only the handful of tags below are kept, as pointers into the receive
+// buffer; numbers are converted in place with fixed-point digit loops, so
+// decoding never allocates.
+//
+// ClOrdIDs are opaque strings chosen by the client. Each session hands out
+// its own range of engine order ids and keeps a FixOrderTable from the live
+// ClOrdID to the engine id, plus the OrderQty and CumQty a replace needs:
+// tag 38 on a 35=G is the new total quantity, so the engine is given
+// OrderQty - CumQty as the open quantity. Fills reach the table through
+// FixSessionListener on the engine.
+//
+// Sequence numbers, logon, heartbeats and resends belong to the session
+// layer in front of this decoder; other message types are framed, checked
+// and skipped.
+
+constexpr char FIX_SOH = '\x01';
+constexpr uint64_t FIX_MAX_BODY_LEN = 65536; // Larger BodyLength is treated as a framing error
+constexpr size_t FIX_MAX_CL_ORD_ID_LEN = 32;   // Longer ClOrdIDs are rejected
+
+// Per-session settings the wire does not carry
+struct FixSessionConfig {
+    uint32_t owner = 0;                 // STP owner stamped on every order
+    StpMode stp = StpMode::None;
+    uint32_t price_decimals = 2;        // "50.25" -> 5025 ticks at 2 decimals
+    // 126 ExpireTime is UTC; this is added to it (as ns since the Unix
+    // epoch) to land on the engine clock driving advanceTime. Zero means
+    // the engine clock is itself UTC epoch ns.
+    int64_t clock_offset_ns = 0;
+    // Engine order ids of this session are first_order_id, first_order_id + 1,
+    // ... in entry order; sessions sharing an engine need disjoint ranges
+    uint64_t first_order_id = 1;
+    uint32_t max_orders = 1u << 18;     // New orders per session (day); more are rejected
+};
+
+// clock_offset_ns for an engine driven by std::chrono::steady_clock, as the
+// benchmarks are. Take it once at session start; the two clocks drift
+// apart only as fast as NTP slews the wall clock.
+inline int64_t fixSteadyClockOffsetNs() {
+    auto steady = std::chrono::steady_clock::now().time_since_epoch();
+    auto utc = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(steady).count() -
+           std::chrono::duration_cast<std::chrono::nanoseconds>(utc).count();
+}
+
+namespace fix_detail {
+
+// Bitmasks of the SOH and '=' bytes in a block: bit i is byte i
+struct Delimiters {
+    uint32_t soh;
+    uint32_t eq;
+};
+
+#if defined(__AVX2__)
+constexpr size_t SCAN_WIDTH = 32;
+
+inline Delimiters findDelimiters(const char* p) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(FIX_SOH)))),
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('='))))};
+}
+#elif defined(__SSE2__)
+constexpr size_t SCAN_WIDTH = 16;
+
+inline Delimiters findDelimiters(const char* p) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return {static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(FIX_SOH)))),
+            static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('='))))};
+}
+#else
+constexpr size_t SCAN_WIDTH = 8;
+
+inline Delimiters findDelimiters(const char* p) {
+    Delimiters d{0, 0};
+    for (size_t i = 0; i < SCAN_WIDTH; ++i) {
+        d.soh |= static_cast<uint32_t>(p[i] == FIX_SOH) << i;
+        d.eq |= static_cast<uint32_t>(p[i] == '=') << i;
+    }
+    return d;
+}
+#endif
+
+// Short final block (n < SCAN_WIDTH), without reading past the message
+inline Delimiters findDelimiters(const char* p, size_t n) {
+    Delimiters d{0, 0};
+    for (size_t i = 0; i < n; ++i) {
+        d.soh |= static_cast<uint32_t>(p[i] == FIX_SOH) << i;
+        d.eq |= static_cast<uint32_t>(p[i] == '=') << i;
+    }
+    return d;
+}
+
+// The first two header fields, 8=<BeginString> and 9=<BodyLength>, always
+// fit in this many bytes; their SOHs come from the same delimiter masks as
+// the body instead of a byte-at-a-time search
+constexpr size_t HEADER_WINDOW = 32;
+
+// SOH mask of the first n bytes at p, n <= HEADER_WINDOW
+inline uint32_t headerSoh(const char* p, size_t n) {
+    if (n < HEADER_WINDOW) return findDelimiters(p, n).soh;
+    uint32_t soh = 0;
+    for (size_t i = 0; i < HEADER_WINDOW; i += SCAN_WIDTH) soh |= findDelimiters(p + i).soh << i;
+    return soh;
+}
+
+// Sum of the bytes in [p, p + n), mod 256 (the CheckSum field)
+inline uint32_t byteSum(const char* p, size_t n) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    sum = static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) +
+          static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+#endif
+    for (; i < n; ++i) sum += static_cast<uint8_t>(p[i]);
+    return static_cast<uint32_t>(sum & 0xFF);
+}
+
+// The same sum taken a block at a time, so the field scan adds up the bytes
+// it has already loaded for its delimiter masks instead of a second pass
+class ByteSum {
+private:
+#if defined(__AVX2__)
+    __m256i acc_ = _mm256_setzero_si256();
+#elif defined(__SSE2__)
+    __m128i acc_ = _mm_setzero_si128();
+#endif
+    uint64_t sum_ = 0;
+
+public:
+    // SCAN_WIDTH bytes at p
+    void addBlock(const char* p) {
+#if defined(__AVX2__)
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        acc_ = _mm256_add_epi64(acc_, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+#elif defined(__SSE2__)
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        acc_ = _mm_add_epi64(acc_, _mm_sad_epu8(v, _mm_setzero_si128()));
+#else
+        sum_ += byteSum(p, SCAN_WIDTH);
+#endif
+    }
+
+    void add(const char* p, size_t n) { sum_ += byteSum(p, n); }
+
+    uint32_t value() const {
+        uint64_t sum = sum_;
+#if defined(__AVX2__)
+        __m128i acc = _mm_add_epi64(_mm256_castsi256_si128(acc_), _mm256_extracti128_si256(acc_, 1));
+#elif defined(__SSE2__)
+        __m128i acc = acc_;
+#endif
+#if defined(__SSE2__)
+        sum += static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) +
+               static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+#endif
+        return static_cast<uint32_t>(sum & 0xFF);
+    }
+};
+
+// Unsigned integer, all digits, fits in uint64_t
+inline bool parseUint(const char* p, const char* end, uint64_t& out) {
+    if (p == end || end - p > 19) return false;
+    uint64_t value = 0;
+    for (; p < end; ++p) {
+        uint32_t digit = static_cast<uint32_t>(*p - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+// Decimal to fixed point with `decimals` implied places: "50.25" at 2 is
+// 5025. Extra fractional digits must be zero (the value is on the grid).
+inline bool parseFixed(const char* p, const char* end, uint32_t decimals, uint32_t& out) {
+    uint64_t value = 0;
+    uint32_t digits = 0;
+    const char* dot = nullptr;
+    uint32_t places = 0;
+    for (; p < end; ++p) {
+        if (*p == '.' && !dot) {
+            dot = p;
+            continue;
+        }
+        uint32_t digit = static_cast<uint32_t>(*p - '0');
+        if (digit > 9) return false;
+        if (dot && places == decimals) {
+            if (digit) return false;
+            continue;
+        }
+        value = value * 10 + digit;
+        if (value > UINT32_MAX) return false;
+        places += dot ? 1 : 0;
+        ++digits;
+    }
+    if (!digits) return false;
+    for (; places < decimals; ++places) {
+        value *= 10;
+        if (value > UINT32_MAX) return false;
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+inline int64_t daysFromCivil(int64_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = static_cast<uint32_t>(y - era * 400);
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// UTCTimestamp "YYYYMMDD-HH:MM:SS[.fff...]" to ns since the Unix epoch
+inline bool parseUtcTimestamp(const char* p, const char* end, uint64_t& out) {
+    if (end - p < 17 || p[8] != '-' || p[11] != ':' || p[14] != ':') return false;
+    uint64_t date, hh, mm, ss;
+    if (!parseUint(p, p + 8, date) || !parseUint(p + 9, p + 11, hh) ||
+        !parseUint(p + 12, p + 14, mm) || !parseUint(p + 15, p + 17, ss)) {
+        return false;
+    }
+    uint32_t month = static_cast<uint32_t>(date / 100 % 100);
+    uint32_t day = static_cast<uint32_t>(date % 100);
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hh > 23 || mm > 59 || ss > 60) return false;
+
+    uint64_t frac_ns = 0;
+    if (end - p > 17) {
+        if (p[17] != '.' || end - p > 27) return false;
+        if (!parseUint(p + 18, end, frac_ns)) return false;
+        for (auto n = end - (p + 18); n < 9; ++n) frac_ns *= 10;
+    }
+
+    int64_t days = daysFromCivil(static_cast<int64_t>(date / 10000), month, day);
+    if (days < 0) return false;
+    out = ((static_cast<uint64_t>(days) * 86400 + hh * 3600 + mm * 60 + ss) * 1000000000ULL) + frac_ns;
+    return true;
+}
+
+} // namespace fix_detail
+
+// Orders of one FIX session, indexed both ways: by engine id, which is
+// first_order_id plus the entry's position, and by the live ClOrdID through
+// an open-addressing table of entry positions (linear probing,
+// backward-shift deletion, as in OrderIndex). Both are sized once from
+// max_orders. A replace re-keys its entry to the new ClOrdID; the engine id
+// never changes.
+class FixOrderTable {
+private:
+    struct Entry {
+        char cl_ord_id[FIX_MAX_CL_ORD_ID_LEN];
+        uint32_t cl_ord_id_len;
+        uint32_t order_qty;  // 38 of the last accepted D or G
+        uint32_t cum_qty;    // Filled so far, across replaces
+    };
+
+    // A slot keeps the key's hash next to the entry position, so probing
+    // past other keys compares hashes and only a match reads the entry
+    struct Slot {
+        uint32_t entry;  // EMPTY if free
+        uint32_t hash;
+    };
+
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    uint64_t first_id_;
+    std::vector<Entry> entries_;
+    size_t count_ = 0;
+    std::vector<Slot> slots_;
+    size_t mask_;
+
+    // Clients number their ClOrdIDs: a fixed prefix and a counter. Only the
+    // prefix is hashed (FNV-1a) and the trailing counter is added on top,
+    // so consecutive ids land in adjacent slots, as consecutive engine ids
+    // do in OrderIndex, rather than costing a cache miss each.
+    static uint32_t hash(std::string_view key) {
+        size_t prefix = key.size();
+        while (prefix > 0 && key.size() - prefix < 9 && static_cast<uint32_t>(key[prefix - 1] - '0') <= 9) --prefix;
+        uint32_t counter = 0;
+        for (size_t i = prefix; i < key.size(); ++i) counter = counter * 10 + static_cast<uint32_t>(key[i] - '0');
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < prefix; ++i) h = (h ^ static_cast<uint8_t>(key[i])) * 0x100000001B3ULL;
+        return static_cast<uint32_t>(h ^ (h >> 32)) + counter;
+    }
+
+    std::string_view key(uint32_t entry) const {
+        return std::string_view(entries_[entry].cl_ord_id, entries_[entry].cl_ord_id_len);
+    }
+
+    // Slot holding key, or the empty slot ending its probe chain
+    size_t probe(std::string_view cl_ord_id, uint32_t h) const {
+        size_t i = h & mask_;
+        while (slots_[i].entry != EMPTY && (slots_[i].hash != h || key(slots_[i].entry) != cl_ord_id)) {
+            i = (i + 1) & mask_;
+        }
+        return i;
+    }
+
+    void erase(size_t i) {
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask_;
+            if (slots_[j].entry == EMPTY) break;
+            size_t home = slots_[j].hash & mask_;
+            if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i].entry = EMPTY;
+    }
+
+public:
+    FixOrderTable(uint64_t first_id, uint32_t max_orders) : first_id_(first_id), entries_(max_orders) {
+        size_t capacity = 2;
+        while (capacity < size_t(max_orders) * 2) capacity <<= 1;
+        slots_.assign(capacity, Slot{EMPTY, 0});
+        mask_ = capacity - 1;
+    }
+
+    static bool validClOrdId(std::string_view cl_ord_id) {
+        return !cl_ord_id.empty() && cl_ord_id.size() <= FIX_MAX_CL_ORD_ID_LEN;
+    }
+
+    // Hash of a ClOrdID, with its home slot already on its way into cache;
+    // hand it to contains() and bind() once the rest of the message is parsed
+    uint32_t prefetch(std::string_view cl_ord_id) const {
+        const uint32_t h = hash(cl_ord_id);
+        __builtin_prefetch(&slots_[h & mask_]);
+        return h;
+    }
+
+    bool contains(std::string_view cl_ord_id, uint32_t h) const {
+        return slots_[probe(cl_ord_id, h)].entry != EMPTY;
+    }
+
+    bool full() const { return count_ == entries_.size(); }
+
+    // Take the next engine id for an order of order_qty. It is not found by
+    // ClOrdID until bind(), so an order the engine refuses never is.
+    uint64_t open(uint32_t order_qty) {
+        Entry& entry = entries_[count_];
+        entry.cl_ord_id_len = 0;
+        entry.order_qty = order_qty;
+        entry.cum_qty = 0;
+        return first_id_ + count_++;
+    }
+
+    // Key id under cl_ord_id (valid, not live, h its prefetch()), dropping
+    // its previous key
+    void bind(uint64_t id, std::string_view cl_ord_id, uint32_t h) {
+        const uint32_t entry = static_cast<uint32_t>(id - first_id_);
+        if (entries_[entry].cl_ord_id_len) erase(probe(key(entry), hash(key(entry))));
+        std::memcpy(entries_[entry].cl_ord_id, cl_ord_id.data(), cl_ord_id.size());
+        entries_[entry].cl_ord_id_len = static_cast<uint32_t>(cl_ord_id.size());
+        slots_[probe(cl_ord_id, h)] = Slot{entry, h};
+    }
+
+    bool find(std::string_view cl_ord_id, uint64_t& id) const {
+        const uint32_t entry = slots_[probe(cl_ord_id, hash(cl_ord_id))].entry;
+        if (entry == EMPTY) return false;
+        id = first_id_ + entry;
+        return true;
+    }
+
+    // Current ClOrdID of an engine id, empty if it is not this session's
+    std::string_view clOrdId(uint64_t id) const {
+        return owns(id) ? key(static_cast<uint32_t>(id - first_id_)) : std::string_view();
+    }
+
+    bool owns(uint64_t id) const { return id >= first_id_ && id - first_id_ < count_; }
+
+    uint32_t orderQty(uint64_t id) const { return entries_[id - first_id_].order_qty; }
+    uint32_t cumQty(uint64_t id) const { return entries_[id - first_id_].cum_qty; }
+    void setOrderQty(uint64_t id, uint32_t order_qty) { entries_[id - first_id_].order_qty = order_qty; }
+
+    void addFill(uint64_t id, uint32_t qty) {
+        if (owns(id)) entries_[id - first_id_].cum_qty += qty;
+    }
+};
+
+// Streaming decoder for one FIX session; see the top of the file
+class FixDecoder {
+private:
+    // Value of one tag: [begin, end) in the receive buffer, empty if absent
+    struct Field {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        bool present() const { return begin != nullptr; }
+    };
+
+    // The tags the three messages need
+    struct Fields {
+        Field msg_type;       // 35
+        Field cl_ord_id;      // 11
+        Field orig_cl_ord_id; // 41
+        Field side;           // 54
+        Field order_qty;      // 38
+        Field ord_type;       // 40
+        Field price;          // 44
+        Field stop_px;        // 99
+        Field tif;            // 59
+        Field exec_inst;      // 18
+        Field max_floor;      // 111
+        Field expire_time;    // 126
+        Field security_id;    // 48
+        Field ignored;        // Sink for every other tag
+    };
+
+    // Tag number -> slot; every wanted tag is below 128, so a field is kept
+    // with one table load and no compare chain
+    static constexpr uint32_t MAX_KEPT_TAG = 128;
+    using Slot = Field Fields::*;
+    struct SlotTable {
+        Slot slots[MAX_KEPT_TAG];
+        constexpr SlotTable() : slots() {
+            for (auto& slot : slots) slot = &Fields::ignored;
+            slots[35] = &Fields::msg_type;
+            slots[11] = &Fields::cl_ord_id;
+            slots[41] = &Fields::orig_cl_ord_id;
+            slots[54] = &Fields::side;
+            slots[38] = &Fields::order_qty;
+            slots[40] = &Fields::ord_type;
+            slots[44] = &Fields::price;
+            slots[99] = &Fields::stop_px;
+            slots[59] = &Fields::tif;
+            slots[18] = &Fields::exec_inst;
+            slots[111] = &Fields::max_floor;
+            slots[126] = &Fields::expire_time;
+            slots[48] = &Fields::security_id;
+        }
+    };
+
+    FixSessionConfig config_;
+    FixOrderTable orders_;
+    bool malformed_ = false;
+    uint64_t garbled_ = 0;   // Checksum failures, dropped as FIX requires
+    uint64_t rejected_ = 0;  // Missing or invalid fields, duplicate or unknown ClOrdIDs
+    uint64_t skipped_ = 0;   // Well-formed messages of other types
+
+    size_t fail(size_t pos) {
+        malformed_ = true;
+        return pos;
+    }
+
+    static void keep(Fields& f, const char* tag, const char* eq, const char* soh) {
+        static constexpr SlotTable TABLE;
+        uint32_t number = 0;
+        bool invalid = eq - tag > 3; // Never a kept tag, and keeps number from overflowing
+        for (const char* c = tag; c < eq; ++c) {
+            uint32_t digit = static_cast<uint32_t>(*c - '0');
+            invalid |= digit > 9;
+            number = number * 10 + digit;
+        }
+        Field& slot = f.*TABLE.slots[!invalid && number < MAX_KEPT_TAG ? number : 0];
+        slot.begin = eq + 1;
+        slot.end = soh;
+    }
+
+    // Split [p, end) into tag=value fields; end is just past the last SOH.
+    // The SOH and '=' masks are walked in lockstep: a field's tag ends at
+    // the first '=' after its start, and any '=' inside its value is
+    // dropped when its SOH is consumed. One iteration per field. Each block
+    // is added to sum as it is loaded; a false return may leave it partial.
+    static bool scanFields(const char* p, const char* end, Fields& f, fix_detail::ByteSum& sum) {
+        const char* field = p;
+        const char* eq = nullptr;
+        const size_t len = static_cast<size_t>(end - p);
+        for (size_t i = 0; i < len; i += fix_detail::SCAN_WIDTH) {
+            const char* block = p + i;
+            fix_detail::Delimiters d;
+            if (len - i >= fix_detail::SCAN_WIDTH) {
+                d = fix_detail::findDelimiters(block);
+                sum.addBlock(block);
+            } else {
+                d = fix_detail::findDelimiters(block, len - i);
+                sum.add(block, len - i);
+            }
+
+            while (d.soh) {
+                uint32_t at = static_cast<uint32_t>(__builtin_ctz(d.soh));
+                if (!eq) {
+                    if (!d.eq) return false;
+                    eq = block + __builtin_ctz(d.eq);
+                    if (eq > block + at) return false;
+                }
+                if (eq == field) return false;
+                keep(f, field, eq, block + at);
+                field = block + at + 1;
+                eq = nullptr;
+                d.eq &= ~0u << at;
+                d.soh &= d.soh - 1;
+            }
+            // The open field's '=' may follow the block's last SOH
+            if (!eq && d.eq) eq = block + __builtin_ctz(d.eq);
+        }
+        return field == end;
+    }
+
+    static bool singleChar(const Field& field, char& out) {
+        if (field.end - field.begin != 1) return false;
+        out = *field.begin;
+        return true;
+    }
+
+    static std::string_view view(const Field& field) {
+        return std::string_view(field.begin, static_cast<size_t>(field.end - field.begin));
+    }
+
+    template <typename Engine>
+    bool newOrderSingle(const Fields& f, Engine& engine) {
+        uint32_t qty;
+        char side, ord_type;
+        const std::string_view cl_ord_id = view(f.cl_ord_id);
+        if (!FixOrderTable::validClOrdId(cl_ord_id) || orders_.full()) return false;
+        // The duplicate check waits until the fields are parsed, so the
+        // table's cache miss overlaps them
+        const uint32_t cl_ord_id_hash = orders_.prefetch(cl_ord_id);
+        if (!f.order_qty.present() || !fix_detail::parseFixed(f.order_qty.begin, f.order_qty.end, 0, qty) ||
+            !singleChar(f.side, side) || (side != '1' && side != '2') ||
+            !singleChar(f.ord_type, ord_type)) {
+            return false;
+        }
+
+        // 40: 1 Market, 2 Limit, 3 Stop, 4 StopLimit; 18 containing '6'
+        // (participate don't initiate) makes a limit post-only
+        OrderType type;
+        bool needs_price = false;
+        bool needs_stop = false;
+        switch (ord_type) {
+            case '1': type = OrderType::Market; break;
+            case '2': type = OrderType::Limit; needs_price = true; break;
+            case '3': type = OrderType::Stop; needs_stop = true; break;
+            case '4': type = OrderType::StopLimit; needs_price = needs_stop = true; break;
+            default: return false;
+        }
+        for (const char* c = f.exec_inst.begin; c && c < f.exec_inst.end; ++c) {
+            if (*c == '6' && type == OrderType::Limit) type = OrderType::PostOnly;
+        }
+
+        uint32_t price = 0;
+        uint32_t stop_price = 0;
+        if (needs_price && (!f.price.present() ||
+                            !fix_detail::parseFixed(f.price.begin, f.price.end, config_.price_decimals, price))) {
+            return false;
+        }
+        if (needs_stop && (!f.stop_px.present() ||
+                           !fix_detail::parseFixed(f.stop_px.begin, f.stop_px.end, config_.price_decimals, stop_price))) {
+            return false;
+        }
+
+        // 59: 0 Day and 1 GTC rest (the engine has no session close),
+        // 3 IOC, 4 FOK, 6 GTD with 126 ExpireTime (UTC) moved onto the engine
+        // clock by clock_offset_ns
+        TimeInForce tif = TimeInForce::GTC;
+        uint64_t expire_time = 0;
+        char tif_char = '0';
+        if (f.tif.present() && !singleChar(f.tif, tif_char)) return false;
+        switch (tif_char) {
+            case '0': case '1': break;
+            case '3': tif = TimeInForce::IOC; break;
+            case '4': tif = TimeInForce::FOK; break;
+            case '6':
+                tif = TimeInForce::GTD;
+                if (!f.expire_time.present() ||
+                    !fix_detail::parseUtcTimestamp(f.expire_time.begin, f.expire_time.end, expire_time)) {
+                    return false;
+                }
+                // An ExpireTime before the engine clock's origin is already
+                // past; 1 keeps it non-zero so the engine rejects it as such
+                if (config_.clock_offset_ns < 0 && expire_time <= static_cast<uint64_t>(-config_.clock_offset_ns)) {
+                    expire_time = 1;
+                } else {
+                    expire_time += static_cast<uint64_t>(config_.clock_offset_ns);
+                }
+                break;
+            default: return false;
+        }
+
+        uint32_t display_qty = 0;
+        if (f.max_floor.present() && !fix_detail::parseFixed(f.max_floor.begin, f.max_floor.end, 0, display_qty)) {
+            return false;
+        }
+        uint64_t instrument = 0;
+        if (f.security_id.present() &&
+            (!fix_detail::parseUint(f.security_id.begin, f.security_id.end, instrument) || instrument >= ALL_INSTRUMENTS)) {
+            return false;
+        }
+
+        if (orders_.contains(cl_ord_id, cl_ord_id_hash)) return false;
+
+        const uint64_t id = orders_.open(qty);
+        if (engine.processNewOrder(id, price, qty, side == '1', type, tif, display_qty, stop_price, expire_time,
+                                   config_.owner, config_.stp, static_cast<uint32_t>(instrument))) {
+            orders_.bind(id, cl_ord_id, cl_ord_id_hash);
+        }
+        return true;
+    }
+
+    // 35=F and 35=G address the live order by OrigClOrdID (41). An accepted
+    // replace re-keys it to its new ClOrdID (11) and OrderQty (38); the
+    // engine gets the open quantity, OrderQty less what has already filled,
+    // and cancels the order if nothing is left open.
+    template <typename Engine>
+    bool cancelOrReplace(const Fields& f, bool replace, Engine& engine) {
+        uint64_t id;
+        if (!orders_.find(view(f.orig_cl_ord_id), id)) return false;
+        if (!replace) {
+            engine.processCancel(id);
+            return true;
+        }
+
+        uint32_t price, qty;
+        const std::string_view cl_ord_id = view(f.cl_ord_id);
+        if (!FixOrderTable::validClOrdId(cl_ord_id)) return false;
+        const uint32_t cl_ord_id_hash = orders_.prefetch(cl_ord_id);
+        if (orders_.contains(cl_ord_id, cl_ord_id_hash) ||
+            !f.price.present() || !fix_detail::parseFixed(f.price.begin, f.price.end, config_.price_decimals, price) ||
+            !f.order_qty.present() || !fix_detail::parseFixed(f.order_qty.begin, f.order_qty.end, 0, qty)) {
+            return false;
+        }
+        const uint32_t cum_qty = orders_.cumQty(id);
+        if (engine.processModify(id, price, qty > cum_qty ? qty - cum_qty : 0)) {
+            orders_.bind(id, cl_ord_id, cl_ord_id_hash);
+            orders_.setOrderQty(id, qty);
+        }
+        return true;
+    }
+
+public:
+    explicit FixDecoder(const FixSessionConfig& config = FixSessionConfig())
+        : config_(config), orders_(config.first_order_id, config.max_orders) {}
+
+    // Decode every complete message in [data, data + len) and return the
+    // bytes consumed; a trailing partial message is left for the caller to
+    // carry over. A framing error (no 8=/9=/10= where the header says)
+    // stops decoding and sets malformed(): the session cannot resync.
+    template <typename Engine>
+    size_t decode(const char* data, size_t len, Engine& engine) {
+        size_t pos = 0;
+        while (pos < len) {
+            const char* m = data + pos;
+            const char* end = data + len;
+
+            // 8=FIX.4.x<SOH>9=<len><SOH>: the first two SOHs of one mask
+            const size_t avail = static_cast<size_t>(end - m);
+            if (avail < 2) break;
+            if (m[0] != '8' || m[1] != '=') return fail(pos);
+            uint32_t soh = fix_detail::headerSoh(m, avail < fix_detail::HEADER_WINDOW ? avail : fix_detail::HEADER_WINDOW);
+            if (__builtin_popcount(soh) < 2) {
+                if (avail < fix_detail::HEADER_WINDOW) break; // Rest of the header not received yet
+                return fail(pos);
+            }
+            const char* begin_string_end = m + __builtin_ctz(soh);
+            const char* len_end = m + __builtin_ctz(soh & (soh - 1));
+            if (begin_string_end[1] != '9' || begin_string_end[2] != '=') return fail(pos);
+            uint64_t body_len;
+            if (!fix_detail::parseUint(begin_string_end + 3, len_end, body_len) || body_len > FIX_MAX_BODY_LEN) {
+                return fail(pos);
+            }
+
+            // Body, then 10=nnn<SOH>
+            const char* body = len_end + 1;
+            if (static_cast<size_t>(end - body) < body_len + 7) break;
+            const char* trailer = body + body_len;
+            uint64_t checksum;
+            if (trailer[0] != '1' || trailer[1] != '0' || trailer[2] != '=' || trailer[6] != FIX_SOH ||
+                !fix_detail::parseUint(trailer + 3, trailer + 6, checksum)) {
+                return fail(pos);
+            }
+            pos = static_cast<size_t>(trailer + 7 - data);
+
+            // The checksum is summed by the field scan; one that stopped at
+            // a bad field is summed again in full, as a garbled message
+            // counts as garbled rather than rejected
+            Fields f;
+            fix_detail::ByteSum sum;
+            sum.add(m, static_cast<size_t>(body - m));
+            const bool scanned = scanFields(body, trailer, f, sum);
+            const uint32_t actual = scanned ? sum.value() : fix_detail::byteSum(m, static_cast<size_t>(trailer - m));
+            if (actual != checksum) {
+                ++garbled_;
+                continue;
+            }
+
+            char msg_type;
+            if (!scanned || !singleChar(f.msg_type, msg_type)) {
+                ++rejected_;
+                continue;
+            }
+
+            bool ok;
+            switch (msg_type) {
+                case 'D': ok = newOrderSingle(f, engine); break;
+                case 'F': ok = cancelOrReplace(f, false, engine); break;
+                case 'G': ok = cancelOrReplace(f, true, engine); break;
+                default: ++skipped_; continue;
+            }
+            if (!ok) ++rejected_;
+        }
+        return pos;
+    }
+
+    bool malformed() const { return malformed_; }
+    uint64_t garbled() const { return garbled_; }
+    uint64_t rejected() const { return rejected_; }
+    uint64_t skipped() const { return skipped_; }
+
+    const FixOrderTable& orders() const { return orders_; }
+
+    // A fill of qty on an engine order; ignored unless it is this session's
+    void onFill(uint64_t id, uint32_t qty) { orders_.addFill(id, qty); }
+};
+
+// Feeds the engine's fills back into one session's CumQty. Tee it with the
+// exec report listener; one per session, or nest tees for several.
+class FixSessionListener : public NullListener {
+private:
+    FixDecoder* session_;
+
+public:
+    explicit FixSessionListener(FixDecoder* session) : session_(session) {}
+
+    void onTrade(const Order& aggressor, const Order& resting, uint32_t, uint32_t qty) {
+        session_->onFill(aggressor.id, qty);
+        session_->onFill(resting.id, qty);
+    }
+};
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SpscQueue.h"
+
+// Asynchronous write-ahead journal of sequenced inbound messages.
+//
+// The sequencing thread (normally the matching thread, in the order it
+// consumes messages) stamps each message with a gap-free sequence number and
+// the engine clock and claims it into an SPSC ring; that is all it ever
+// pays. A dedicated journal thread runs JournalWriter::poll(), which pops
+// records straight into an mmap'd append-only file and then applies the
+// configured durability to the whole group it drained. While a sync is in
+// flight the ring keeps filling, so the next group is larger: group commit
+// falls out of the ring instead of a timer.
+//
+// Records repeat their sequence number at both ends. Replay stops at the
+// first record that is zeroed, out of sequence or torn across a page that
+// did not reach disk, so the day is rebuilt from the longest intact prefix.
+
+enum class JournalDurability : uint8_t {
+    None,          // Page cache only: survives a process crash, not a power loss
+    PeriodicMsync, // msync(MS_SYNC) of the unsynced tail every sync_interval_ns
+    GroupCommit,   // fdatasync after every group drained from the ring
+};
+
+struct JournalConfig {
+    JournalDurability durability = JournalDurability::None;
+    uint64_t sync_interval_ns = 1000000;       // PeriodicMsync only
+    size_t initial_bytes = size_t(64) << 20;   // File grows by doubling
+};
+
+constexpr uint64_t JOURNAL_MAGIC = 0x4E4D4A52'4E414C31ULL; // "NMJRNAL1"
+constexpr uint32_t JOURNAL_VERSION = 1;
+constexpr size_t JOURNAL_QUEUE_CAPACITY = 65536;
+constexpr size_t JOURNAL_HEADER_BYTES = 4096; // Header page; records start after it
+constexpr size_t JOURNAL_GROUP_MAX = 4096;    // Records popped per ring index publish
+
+template <typename Message>
+struct JournalRecord {
+    uint64_t sequence;      // 1-based, gap-free
+    uint64_t timestamp;     // Engine clock when the message was sequenced
+    Message message;
+    uint64_t end_sequence;  // Equals sequence once the whole record is written
+};
+
+template <typename Message>
+using JournalQueue = SpscQueue<JournalRecord<Message>, JOURNAL_QUEUE_CAPACITY>;
+
+// File layout at offset 0; written once when the file is created
+struct JournalFileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+};
+
+namespace journal_detail {
+
+[[noreturn]] inline void fail(const std::string& what) {
+    throw std::runtime_error("Journal: " + what + ": " + std::strerror(errno));
+}
+
+template <typename Message>
+bool intact(const JournalRecord<Message>& record, uint64_t expected) {
+    return record.sequence == expected && record.end_sequence == expected;
+}
+
+} // namespace journal_detail
+
+// Sequencing side: one thread, in processing order
+template <typename Message>
+class JournalSequencer {
+private:
+    JournalQueue<Message>* queue_;
+    uint64_t next_sequence_;
+
+public:
+    // Resume from JournalWriter::nextSequence() when reopening a journal
+    JournalSequencer(JournalQueue<Message>* queue, uint64_t next_sequence = 1)
+        : queue_(queue), next_sequence_(next_sequence) {}
+
+    uint64_t append(const Message& message, uint64_t timestamp) {
+        JournalRecord<Message>* slot;
+        while (!(slot = queue_->claim())) {
+            // Backpressure: the journal thread is a full ring behind
+        }
+        const uint64_t sequence = next_sequence_++;
+        slot->sequence = sequence;
+        slot->timestamp = timestamp;
+        slot->message = message;
+        slot->end_sequence = sequence;
+        queue_->commit();
+        return sequence;
+    }
+
+    uint64_t nextSequence() const { return next_sequence_; }
+};
+
+// Journal side: owns the file and mapping, and is driven by one thread
+template <typename Message>
+class JournalWriter {
+    static_assert(std::is_trivially_copyable<Message>::value, "Journaled messages must be trivially copyable");
+    using Record = JournalRecord<Message>;
+
+private:
+    JournalQueue<Message>* queue_;
+    JournalConfig config_;
+    int fd_ = -1;
+    char* mapping_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    size_t write_offset_ = JOURNAL_HEADER_BYTES;   // End of the last record written
+    size_t synced_offset_ = JOURNAL_HEADER_BYTES;  // End of the last record synced
+    uint64_t next_sequence_ = 1;
+    uint64_t last_sync_ns_ = 0;
+    uint64_t groups_ = 0;
+    uint64_t syncs_ = 0;
+    alignas(64) std::atomic<uint64_t> durable_sequence_{0};
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void map(size_t bytes) {
+        if (ftruncate(fd_, bytes) != 0) journal_detail::fail("ftruncate");
+        void* mapping = mapping_
+            ? mremap(mapping_, mapped_bytes_, bytes, MREMAP_MAYMOVE)
+            : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) journal_detail::fail(mapping_ ? "mremap" : "mmap");
+        mapping_ = static_cast<char*>(mapping);
+        mapped_bytes_ = bytes;
+    }
+
+    // Reopened file: find the end of the intact prefix and zero everything
+    // after it, so records left beyond a torn one can never be replayed
+    // behind the new ones
+    void recover() {
+        const JournalFileHeader* header = reinterpret_cast<const JournalFileHeader*>(mapping_);
+        if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION ||
+            header->record_size != sizeof(Record)) {
+            errno = EPROTO;
+            journal_detail::fail("layout mismatch");
+        }
+        while (write_offset_ + sizeof(Record) <= mapped_bytes_ &&
+               journal_detail::intact(*reinterpret_cast<const Record*>(mapping_ + write_offset_), next_sequence_)) {
+            write_offset_ += sizeof(Record);
+            ++next_sequence_;
+        }
+        std::memset(mapping_ + write_offset_, 0, mapped_bytes_ - write_offset_);
+        if (fdatasync(fd_) != 0) journal_detail::fail("fdatasync");
+        synced_offset_ = write_offset_;
+        durable_sequence_.store(next_sequence_ - 1, std::memory_order_release);
+    }
+
+    void release() {
+        if (mapping_) munmap(mapping_, mapped_bytes_);
+        if (fd_ >= 0) close(fd_);
+        mapping_ = nullptr;
+        fd_ = -1;
+    }
+
+public:
+    // Creates path, or reopens it and resumes after its last intact record
+    JournalWriter(JournalQueue<Message>* queue, const std::string& path, JournalConfig config = {})
+        : queue_(queue), config_(config) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) journal_detail::fail("open " + path);
+        try {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) journal_detail::fail("fstat");
+            const bool created = (st.st_size == 0);
+            size_t bytes = std::max(config_.initial_bytes, JOURNAL_HEADER_BYTES + JOURNAL_GROUP_MAX * sizeof(Record));
+            map(std::max(bytes, static_cast<size_t>(st.st_size)));
+            if (created) {
+                JournalFileHeader header{JOURNAL_MAGIC, JOURNAL_VERSION, static_cast<uint32_t>(sizeof(Record))};
+                std::memcpy(mapping_, &header, sizeof(header));
+                if (fdatasync(fd_) != 0) journal_detail::fail("fdatasync");
+            } else {
+                recover();
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+        last_sync_ns_ = nowNs();
+    }
+
+    ~JournalWriter() { release(); }
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Drain what is queued into the file as one group, then apply the
+    // durability mode. Returns the records written; call from the journal
+    // thread only.
+    size_t poll() {
+        size_t total = 0;
+        for (;;) {
+            if (write_offset_ + JOURNAL_GROUP_MAX * sizeof(Record) > mapped_bytes_) map(mapped_bytes_ * 2);
+            Record* out = reinterpret_cast<Record*>(mapping_ + write_offset_);
+            size_t n = queue_->popN(out, JOURNAL_GROUP_MAX);
+            write_offset_ += n * sizeof(Record);
+            total += n;
+            // A short pop means the ring was drained; stopping there keeps a
+            // producer that never lets up from postponing the sync forever
+            if (n < JOURNAL_GROUP_MAX) break;
+        }
+        if (total) {
+            next_sequence_ += total;
+            ++groups_;
+        }
+
+        switch (config_.durability) {
+        case JournalDurability::None:
+            if (total) durable_sequence_.store(next_sequence_ - 1, std::memory_order_release);
+            break;
+        case JournalDurability::PeriodicMsync:
+            if (write_offset_ != synced_offset_ && nowNs() - last_sync_ns_ >= config_.sync_interval_ns) sync();
+            break;
+        case JournalDurability::GroupCommit:
+            if (total) sync();
+            break;
+        }
+        return total;
+    }
+
+    // Force everything written so far to disk; also call once at shutdown
+    void sync() {
+        if (write_offset_ == synced_offset_) return;
+        if (config_.durability == JournalDurability::PeriodicMsync) {
+            // msync wants a page-aligned start
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t from = synced_offset_ & ~(page - 1);
+            if (msync(mapping_ + from, write_offset_ - from, MS_SYNC) != 0) journal_detail::fail("msync");
+        } else {
+            if (fdatasync(fd_) != 0) journal_detail::fail("fdatasync");
+        }
+        synced_offset_ = write_offset_;
+        last_sync_ns_ = nowNs();
+        ++syncs_;
+        durable_sequence_.store(next_sequence_ - 1, std::memory_order_release);
+    }
+
+    // Highest sequence on disk under the configured mode; any thread may
+    // read it, e.g. a gateway holding acks until they are durable
+    uint64_t durableSequence() const { return durable_sequence_.load(std::memory_order_acquire); }
+
+    uint64_t nextSequence() const { return next_sequence_; }
+    uint64_t groups() const { return groups_; }
+    uint64_t syncs() const { return syncs_; }
+    size_t bytesWritten() const { return write_offset_ - JOURNAL_HEADER_BYTES; }
+};
+
+// Read a journal back, calling fn(const JournalRecord<Message>&) for each
+// record of its intact prefix in sequence order. Returns the records
+// replayed. Replaying them into a fresh engine, with advanceTime(timestamp)
+// whenever the timestamp moves, rebuilds the book the journal recorded.
+template <typename Message, typename Fn>
+uint64_t replayJournal(const std::string& path, Fn&& fn) {
+    using Record = JournalRecord<Message>;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) journal_detail::fail("open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        journal_detail::fail("fstat");
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes < JOURNAL_HEADER_BYTES) {
+        close(fd);
+        errno = EPROTO;
+        journal_detail::fail("truncated header");
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) journal_detail::fail("mmap");
+
+    const char* base = static_cast<const char*>(mapping);
+    const JournalFileHeader* header = reinterpret_cast<const JournalFileHeader*>(base);
+    if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION ||
+        header->record_size != sizeof(Record)) {
+        munmap(mapping, bytes);
+        errno = EPROTO;
+        journal_detail::fail("layout mismatch");
+    }
+
+    uint64_t sequence = 1;
+    for (size_t offset = JOURNAL_HEADER_BYTES; offset + sizeof(Record) <= bytes; offset += sizeof(Record)) {
+        const Record& record = *reinterpret_cast<const Record*>(base + offset);
+        if (!journal_detail::intact(record, sequence)) break;
+        fn(record);
+        ++sequence;
+    }
+    munmap(mapping, bytes);
+    return sequence - 1;
+}
+
+#endif
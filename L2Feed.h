@@ -0,0 +1,112 @@
+#ifndef L2FEED_H
+#define L2FEED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EngineListener.h"
+#include "OrderBook.h"
+#include "SpscQueue.h"
+#include "Types.h"
+
+// Conflated market-by-price (L2) feed.
+//
+// Book events only mark their price level dirty, in a FastPriceTracker per
+// instrument side, so a sweep that hits the same levels hundreds of times
+// costs one bit OR per event. At the end of a batch (or conflation
+// interval) flush() walks just the dirty bits, reads each level's
+// maintained aggregates, and emits the levels whose displayed qty or order
+// count differ from what was last published. Intermediate states and
+// changes that net out inside the interval are never sent.
+
+#pragma pack(push, 1)
+
+struct L2Update {
+    char side;              // 'B' or 'S'
+    uint32_t instrument;
+    uint32_t price;
+    uint64_t qty;           // Displayed qty at the level, 0 once it empties
+    uint32_t order_count;
+};
+
+#pragma pack(pop)
+
+constexpr size_t L2_QUEUE_CAPACITY = 16384;
+using L2Queue = SpscQueue<L2Update, L2_QUEUE_CAPACITY>;
+
+class L2Conflator {
+private:
+    // Last published state of one level
+    struct LevelSnapshot {
+        uint64_t qty = 0;
+        uint32_t order_count = 0;
+    };
+
+    uint32_t instruments_;
+    std::vector<FastPriceTracker> dirty_;       // [instrument * 2 + is_buy]
+    std::vector<LevelSnapshot> published_;      // [(instrument * 2 + is_buy) * MAX_PRICE_TICKS + price]
+
+public:
+    explicit L2Conflator(uint32_t instruments = 1)
+        : instruments_(instruments),
+          dirty_(instruments * 2),
+          published_(static_cast<size_t>(instruments) * 2 * MAX_PRICE_TICKS) {}
+
+    void markDirty(uint32_t instrument, bool is_buy, uint32_t price) {
+        dirty_[instrument * 2 + is_buy].setPriceLevel(price);
+    }
+
+    // Emit the net change of every dirty level through emit(const L2Update&)
+    // and clear the dirty set. Engine is any MatchingEngine instantiation;
+    // call from the matching thread, between batches. Returns the updates
+    // emitted.
+    template <typename Engine, typename Emit>
+    size_t flush(const Engine& engine, Emit&& emit) {
+        size_t emitted = 0;
+        for (uint32_t instrument = 0; instrument < instruments_; ++instrument) {
+            const OrderBook& book = engine.book(instrument);
+            for (uint32_t side = 0; side < 2; ++side) {
+                FastPriceTracker& dirty = dirty_[instrument * 2 + side];
+                if (dirty.isEmpty()) continue;
+
+                bool is_buy = (side == 1);
+                LevelSnapshot* published = &published_[(static_cast<size_t>(instrument) * 2 + side) * MAX_PRICE_TICKS];
+                for (uint32_t p = dirty.getNextAtOrAbove(0); p != MAX_PRICE_TICKS; p = dirty.getNextAtOrAbove(p + 1)) {
+                    dirty.clearPriceLevel(p);
+                    const PriceLevel& level = book.getLevel(is_buy, p);
+                    LevelSnapshot& last = published[p];
+                    if (level.total_qty == last.qty && level.order_count == last.order_count) continue;
+
+                    last.qty = level.total_qty;
+                    last.order_count = level.order_count;
+                    emit(L2Update{is_buy ? 'B' : 'S', instrument, p, level.total_qty, level.order_count});
+                    ++emitted;
+                }
+            }
+        }
+        return emitted;
+    }
+};
+
+// Listener feeding an L2Conflator: every event that can change a visible
+// level marks it dirty. Parked stops are not on the book and are skipped.
+class L2DirtyListener : public NullListener {
+private:
+    L2Conflator* conflator_;
+
+    void touch(const Order& order) { conflator_->markDirty(order.instrument, order.is_buy, order.price); }
+
+public:
+    explicit L2DirtyListener(L2Conflator* conflator) : conflator_(conflator) {}
+
+    void onAdd(const Order& order) {
+        if (order.state == OrderState::Resting) touch(order);
+    }
+    void onTrade(const Order&, const Order& resting, uint32_t, uint32_t) { touch(resting); }
+    void onCancel(const Order& order, CancelReason) {
+        if (order.state == OrderState::Resting) touch(order);
+    }
+    void onModify(const Order& order, uint32_t) { touch(order); }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef MATCHPOLICY_H
+#define MATCHPOLICY_H
+
+#include <algorithm>
+#include <cstdint>
+#include "OrderBook.h"
+#include "Types.h"
+
+// Compile-time matching (allocation) policies for MatchingEngine.
+//
+// A policy decides how an aggressor's qty is shared out among the orders
+// resting at one price level. match(level, qty, fill) is handed the
+// aggressor's remaining qty and calls fill(resting, n) once per allocation,
+// with n no larger than either side's displayed qty. fill executes the trade
+// (or applies self-trade prevention) and returns the aggressor's qty
+// afterwards. A fill may remove the resting order or requeue it at the back
+// (iceberg refill), so policies read next before calling it, and stop
+// each pass at the tail they started with.
+
+// Price-time priority: always fill the head of the queue
+struct FifoMatch {
+    template <typename Fill>
+    static uint32_t match(PriceLevel& level, uint32_t qty, Fill&& fill) {
+        while (qty > 0 && level.head) {
+            qty = fill(level.head, std::min(qty, level.head->qty));
+        }
+        return qty;
+    }
+};
+
+// Pro-rata: each order gets floor(qty * order_qty / level_qty), computed in
+// one pass against the level's displayed aggregate. The rounding remainder
+// is then filled FIFO.
+struct ProRataMatch {
+    template <typename Fill>
+    static uint32_t match(PriceLevel& level, uint32_t qty, Fill&& fill) {
+        qty = allocate(level, qty, fill);
+        return FifoMatch::match(level, qty, fill);
+    }
+
+protected:
+    template <typename Fill>
+    static uint32_t allocate(PriceLevel& level, uint32_t qty, Fill& fill) {
+        const uint64_t incoming = qty;
+        const uint64_t level_qty = level.total_qty;
+        if (level_qty == 0) return qty;
+
+        Order* last = level.tail;
+        Order* order = level.head;
+        while (order && qty > 0) {
+            Order* next = order->next;
+            bool at_end = (order == last);
+            uint32_t share = static_cast<uint32_t>(std::min<uint64_t>(incoming * order->qty / level_qty, order->qty));
+            if (share > 0) qty = fill(order, std::min(share, qty));
+            if (at_end) break;
+            order = next;
+        }
+        return qty;
+    }
+};
+
+// Pro-rata with top-order priority: the order at the head of the level (the
+// one that opened the price) is filled first, up to top_order_cap (0 means
+// uncapped), and the rest is allocated pro-rata.
+struct ProRataTopOrderMatch : ProRataMatch {
+    uint32_t top_order_cap = 0;
+
+    template <typename Fill>
+    uint32_t match(PriceLevel& level, uint32_t qty, Fill&& fill) const {
+        if (level.head) {
+            uint32_t top_qty = std::min(qty, level.head->qty);
+            if (top_order_cap) top_qty = std::min(top_qty, top_order_cap);
+            qty = fill(level.head, top_qty);
+        }
+        return ProRataMatch::match(level, qty, fill);
+    }
+};
+
+// FIFO with a lead market maker: lmm_percent of the qty arriving at each
+// level is first offered to lmm_owner's orders there, in time order, and
+// the remainder is filled FIFO. An lmm_percent of 0 is plain FIFO.
+struct FifoLmmMatch {
+    uint32_t lmm_owner = 0;
+    uint32_t lmm_percent = 0;
+
+    template <typename Fill>
+    uint32_t match(PriceLevel& level, uint32_t qty, Fill&& fill) const {
+        uint32_t lmm_qty = static_cast<uint32_t>(static_cast<uint64_t>(qty) * lmm_percent / 100);
+        Order* last = level.tail;
+        Order* order = level.head;
+        while (order && lmm_qty > 0 && qty > 0) {
+            Order* next = order->next;
+            bool at_end = (order == last);
+            if (order->owner == lmm_owner) {
+                uint32_t n = std::min({lmm_qty, order->qty, qty});
+                lmm_qty -= n;
+                qty = fill(order, n);
+            }
+            if (at_end) break;
+            order = next;
+        }
+        return FifoMatch::match(level, qty, fill);
+    }
+};
+
+#endif
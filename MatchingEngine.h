@@ -1,80 +1,466 @@
+#ifndef MATCHINGENGINE_H
+#define MATCHINGENGINE_H
+
+#include <algorithm>
 #include <iostream>
+#include "EngineListener.h"
+#include "MatchPolicy.h"
 #include "OrderBook.h"
+#include "OrderIndex.h"
+#include "StopBook.h"
+#include "SymbolDirectory.h"
+#include "TimingWheel.h"
 #include "Types.h"
 
+// Listener is a compile-time policy (see EngineListener.h). Its hooks are
+// called directly, so NullListener compiles down to the bare matching code.
+// MatchPolicy picks how fills are allocated within a price level (see
+// MatchPolicy.h); the default is price-time FIFO.
+//
+// One engine matches every instrument in its SymbolDirectory. Order ids are
+// unique across the engine, so cancel/modify need only the id; the index,
+// the timing wheel and the listener are shared by all books.
+template <typename Listener = NullListener, typename MatchPolicy = FifoMatch>
 class MatchingEngine {
 private:
-    OrderBook book_;
-    OrderPool pool_;
+    SymbolDirectory symbols_;
+    OrderIndex index_;
+    TimingWheel timers_;
+    Listener listener_;
+    MatchPolicy policy_;
     uint64_t trades_executed_ = 0;
+    uint64_t now_ = 0; // Engine clock, set by advanceTime
 
 public:
-    void processNewOrder(uint64_t id, uint32_t price, uint32_t qty, bool is_buy) {
-        Order* inbound = pool_.allocate(id, price, qty, is_buy);
+    MatchingEngine() : MatchingEngine(SymbolConfig()) {}
+    explicit MatchingEngine(const Listener& listener, const MatchPolicy& policy = MatchPolicy())
+        : MatchingEngine(SymbolConfig(), listener, policy) {}
+    explicit MatchingEngine(const SymbolConfig& symbols, const Listener& listener = Listener(),
+                            const MatchPolicy& policy = MatchPolicy())
+        : symbols_(symbols), index_(symbols_.orderCapacity()), listener_(listener), policy_(policy) {}
 
-        if (is_buy) {
-            matchBuyOrder(inbound);
-        } else {
-            matchSellOrder(inbound);
+    Listener& listener() { return listener_; }
+    MatchPolicy& policy() { return policy_; }
+
+    const OrderBook& book(uint32_t instrument = 0) const { return symbols_[instrument].book; }
+
+    // Returns false (and raises onReject) if the order is refused.
+    // Market orders ignore price and sweep the opposite side; only GTC limit
+    // and post-only remainders rest, everything else drops its remainder.
+    // A non-zero display_qty makes the resting remainder an iceberg: the
+    // aggressor trades its full size, then only display_qty is shown.
+    // Stop/StopLimit orders park in the stop book until a trade prints
+    // through stop_price (or fire at once if the last trade already has).
+    // GTD orders rest like GTC until expire_time on the advanceTime clock;
+    // until the first advanceTime has started that clock they are rejected.
+    // With an stp mode set, the order never trades against its own owner;
+    // the FOK pre-check still counts own liquidity, so STP can leave an FOK
+    // partly filled.
+    bool processNewOrder(uint64_t id, uint32_t price, uint32_t qty, bool is_buy,
+                         OrderType type = OrderType::Limit, TimeInForce tif = TimeInForce::GTC,
+                         uint32_t display_qty = 0, uint32_t stop_price = 0, uint64_t expire_time = 0,
+                         uint32_t owner = 0, StpMode stp = StpMode::None, uint32_t instrument = 0) {
+        Instrument* inst = symbols_.find(instrument);
+        if (!inst) return reject(id, RejectReason::UnknownInstrument);
+
+        bool is_stop = (type == OrderType::Stop || type == OrderType::StopLimit);
+        if (type == OrderType::Market || type == OrderType::Stop) {
+            price = is_buy ? MAX_PRICE_TICKS - 1 : 0;
+        } else if (price >= MAX_PRICE_TICKS) {
+            return reject(id, RejectReason::InvalidPrice);
         }
+        if (is_stop && stop_price >= MAX_PRICE_TICKS) return reject(id, RejectReason::InvalidPrice);
+        if (qty == 0) return reject(id, RejectReason::InvalidQuantity);
+        // Before the clock starts the wheel sits at tick 0, and an expiry on an
+        // epoch clock would be clamped to the wheel's horizon and never fire
+        if (tif == TimeInForce::GTD && (now_ == 0 || expire_time <= now_)) {
+            return reject(id, RejectReason::InvalidExpiry);
+        }
+        if (index_.find(id)) return reject(id, RejectReason::DuplicateId);
 
-        // If not fully filled, add to the book
-        if (inbound->qty > 0) {
-            book_.addOrder(inbound);
+        if (type == OrderType::PostOnly && wouldCross(inst->book, price, is_buy)) {
+            return reject(id, RejectReason::WouldCross);
+        }
+        if (tif == TimeInForce::FOK && !is_stop && !canFill(inst->book, price, qty, is_buy)) {
+            return reject(id, RejectReason::NotFillable);
+        }
+
+        Order* inbound = inst->pool->allocate(id, price, qty, is_buy);
+        inbound->peak_qty = display_qty;
+        inbound->stop_price = stop_price;
+        inbound->type = type;
+        inbound->tif = tif;
+        inbound->expire_time = expire_time;
+        inbound->owner = owner;
+        inbound->stp = stp;
+        inbound->instrument = instrument;
+
+        if (!is_stop) {
+            enter(*inst, inbound);
+        } else if (StopBook::isTriggered(*inbound, inst->last_trade_price)) {
+            trigger(*inst, inbound);
         } else {
-            pool_.deallocate(inbound);
+            inst->stops.addStop(inbound);
+            inbound->state = OrderState::Stopped;
+            index_.insert(id, inbound);
+            if (tif == TimeInForce::GTD) timers_.schedule(inbound);
+            listener_.onAdd(*inbound);
         }
+
+        releaseStops(*inst);
+        listener_.onBookUpdate(instrument, inst->book);
+        return true;
+    }
+
+    bool processNewOrder(const RawOrder& order) {
+        return processNewOrder(order.id, order.price, order.qty, order.is_buy,
+                               order.type, order.tif, order.display_qty, order.stop_price,
+                               order.expire_time, order.owner, order.stp, order.instrument);
+    }
+
+    // Move the engine clock forward and expire every GTD order due by now.
+    // Each expiry is an O(1) unlink from its book and a return to the pool.
+    void advanceTime(uint64_t now) {
+        if (now_ == 0) timers_.start(now);
+        now_ = now;
+        timers_.advance(now, [this](Order* order) {
+            uint32_t instrument = order->instrument;
+            index_.erase(order->id);
+            cancelOrder(order, CancelReason::Expired);
+            listener_.onBookUpdate(instrument, symbols_[instrument].book);
+        });
+    }
+
+    // O(1) cancel: index lookup, intrusive unlink, tracker bit cleared if the level empties
+    bool processCancel(uint64_t id) {
+        Order* order = index_.erase(id);
+        if (!order) return reject(id, RejectReason::UnknownOrder);
+
+        uint32_t instrument = order->instrument;
+        cancelOrder(order, CancelReason::Requested);
+        listener_.onBookUpdate(instrument, symbols_[instrument].book);
+        return true;
+    }
+
+    // Cancel/replace of a resting order; new_qty is the new open quantity
+    // (displayed plus any iceberg reserve). A size reduction at the same price
+    // is applied in place, reserve first, and keeps its FIFO spot. A price
+    // change or size increase loses priority: the order is unlinked,
+    // re-matched as an aggressor and re-queued at the back. A post-only order
+    // moved to a price that would cross is rejected (WouldCross) and keeps
+    // resting as it was. A parked stop keeps its stop price and is re-parked
+    // with the new terms.
+    bool processModify(uint64_t id, uint32_t new_price, uint32_t new_qty) {
+        if (new_qty == 0) return processCancel(id);
+        if (new_price >= MAX_PRICE_TICKS) return reject(id, RejectReason::InvalidPrice);
+
+        Order* order = index_.find(id);
+        if (!order) return reject(id, RejectReason::UnknownOrder);
+
+        uint32_t instrument = order->instrument;
+        Instrument& inst = symbols_[instrument];
+        uint32_t old_qty = order->qty + order->reserve_qty;
+        if (order->state == OrderState::Resting && new_price == order->price && new_qty <= old_qty) {
+            reduceResting(inst, order, old_qty - new_qty);
+            listener_.onModify(*order, old_qty);
+            listener_.onBookUpdate(instrument, inst.book);
+            return true;
+        }
+
+        // Re-entry goes through enter(), which takes liquidity; a post-only
+        // order must not, so a crossing price is refused and the order kept
+        if (order->type == OrderType::PostOnly && wouldCross(inst.book, new_price, order->is_buy)) {
+            return reject(id, RejectReason::WouldCross);
+        }
+
+        unlink(inst, order);
+        listener_.onCancel(*order, CancelReason::Replaced);
+        if (order->type != OrderType::Stop) order->price = new_price;
+        order->qty = new_qty;
+        order->reserve_qty = 0;
+
+        if (order->state == OrderState::Stopped) {
+            inst.stops.addStop(order);
+            if (order->tif == TimeInForce::GTD) timers_.schedule(order);
+            listener_.onAdd(*order);
+            return true;
+        }
+
+        index_.erase(id);
+        order->state = OrderState::Inbound;
+        enter(inst, order);
+        releaseStops(inst);
+        listener_.onBookUpdate(instrument, inst.book);
+        return true;
+    }
+
+    // Cancel every resting and parked order of owner, in one instrument or
+    // in all of them. Walks only the active levels of each book in scope, so
+    // the cost is proportional to the orders resting there. Returns how many
+    // orders were cancelled.
+    size_t processMassCancel(uint32_t owner, uint32_t instrument = ALL_INSTRUMENTS) {
+        uint32_t first = instrument;
+        uint32_t last = instrument;
+        if (instrument == ALL_INSTRUMENTS) {
+            first = 0;
+            last = symbols_.size() - 1;
+        } else if (!symbols_.find(instrument)) {
+            return 0;
+        }
+
+        size_t cancelled = 0;
+        for (uint32_t i = first; i <= last; ++i) {
+            Instrument& inst = symbols_[i];
+            cancelled += cancelOwned(inst.book.bids_, inst.book.bid_tracker_, owner);
+            cancelled += cancelOwned(inst.book.asks_, inst.book.ask_tracker_, owner);
+            cancelled += cancelOwned(inst.stops.buy_stops_, inst.stops.buy_tracker_, owner);
+            cancelled += cancelOwned(inst.stops.sell_stops_, inst.stops.sell_tracker_, owner);
+            listener_.onBookUpdate(i, inst.book);
+        }
+        return cancelled;
     }
 
     uint64_t getTradesExecuted() const { return trades_executed_; }
 
 private:
-    void matchBuyOrder(Order* inbound) {
-        while (inbound->qty > 0 && book_.best_ask_ <= inbound->price) {
-            PriceLevel& best_ask_level = book_.asks_[book_.best_ask_];
-            Order* resting = best_ask_level.head;
-
-            if (!resting) {
-                book_.updateBestAsk();
-                continue;
+    bool reject(uint64_t id, RejectReason reason) {
+        listener_.onReject(id, reason);
+        return false;
+    }
+
+    // Match an accepted order, then rest or drop whatever is left
+    void enter(Instrument& inst, Order* inbound) {
+        if (inbound->is_buy) {
+            matchBuyOrder(inst, inbound);
+        } else {
+            matchSellOrder(inst, inbound);
+        }
+
+        // If not fully filled, add to the book
+        bool can_rest = (inbound->tif == TimeInForce::GTC || inbound->tif == TimeInForce::GTD);
+        if (inbound->qty > 0 && can_rest && inbound->type != OrderType::Market) {
+            splitDisplay(inbound);
+            inst.book.addOrder(inbound);
+            inbound->state = OrderState::Resting;
+            index_.insert(inbound->id, inbound);
+            if (inbound->tif == TimeInForce::GTD) timers_.schedule(inbound);
+            listener_.onAdd(*inbound);
+        } else {
+            if (inbound->qty > 0) listener_.onCancel(*inbound, CancelReason::Unfilled);
+            inst.pool->deallocate(inbound);
+        }
+    }
+
+    // Take a live order off whichever book holds it, and off the timing wheel
+    void unlink(Instrument& inst, Order* order) {
+        timers_.cancel(order);
+        if (order->state == OrderState::Stopped) {
+            inst.stops.removeStop(order);
+        } else {
+            inst.book.removeOrder(order);
+        }
+    }
+
+    // Unlink an order already removed from the index and return it to the pool
+    void cancelOrder(Order* order, CancelReason reason) {
+        Instrument& inst = symbols_[order->instrument];
+        unlink(inst, order);
+        listener_.onCancel(*order, reason);
+        inst.pool->deallocate(order);
+    }
+
+    // Mass-cancel one side of a book (or stop book): visit active prices only
+    size_t cancelOwned(std::array<PriceLevel, MAX_PRICE_TICKS>& levels, const FastPriceTracker& tracker, uint32_t owner) {
+        size_t cancelled = 0;
+        for (uint32_t p = tracker.getNextAtOrAbove(0); p != MAX_PRICE_TICKS; p = tracker.getNextAtOrAbove(p + 1)) {
+            Order* order = levels[p].head;
+            while (order) {
+                Order* next = order->next;
+                if (order->owner == owner) {
+                    index_.erase(order->id);
+                    cancelOrder(order, CancelReason::Requested);
+                    ++cancelled;
+                }
+                order = next;
+            }
+        }
+        return cancelled;
+    }
+
+    // In-place size reduction of a resting order, reserve first so the
+    // displayed slice (and its queue spot) survives as long as possible
+    void reduceResting(Instrument& inst, Order* order, uint32_t cut) {
+        uint32_t from_reserve = std::min(cut, order->reserve_qty);
+        inst.book.getLevel(order->is_buy, order->price).reduceQty(cut - from_reserve, from_reserve);
+        order->reserve_qty -= from_reserve;
+        order->qty -= cut - from_reserve;
+    }
+
+    // An elected stop enters the book as a market (Stop) or limit (StopLimit) order
+    void trigger(Instrument& inst, Order* stop) {
+        stop->type = (stop->type == OrderType::Stop) ? OrderType::Market : OrderType::Limit;
+        stop->state = OrderState::Inbound;
+        listener_.onTrigger(*stop);
+
+        if (stop->tif == TimeInForce::FOK && !canFill(inst.book, stop->price, stop->qty, stop->is_buy)) {
+            listener_.onCancel(*stop, CancelReason::Unfilled);
+            inst.pool->deallocate(stop);
+            return;
+        }
+        enter(inst, stop);
+    }
+
+    // Elect every stop the last trade printed through. Released stops trade
+    // and move the last price themselves, so cascades are handled by looping
+    // here rather than by recursion.
+    void releaseStops(Instrument& inst) {
+        while (!inst.stops.isEmpty()) {
+            Order* stop = inst.stops.popTriggered(inst.last_trade_price);
+            if (!stop) return;
+            index_.erase(stop->id);
+            timers_.cancel(stop);
+            trigger(inst, stop);
+        }
+    }
+
+    static bool wouldCross(const OrderBook& book, uint32_t price, bool is_buy) {
+        if (is_buy) {
+            return !book.ask_tracker_.isEmpty() && book.ask_tracker_.getBestAsk() <= price;
+        }
+        return !book.bid_tracker_.isEmpty() && book.bid_tracker_.getBestBid() >= price;
+    }
+
+    // Iceberg: show only the peak, hold the rest back as reserve
+    static void splitDisplay(Order* order) {
+        if (order->peak_qty && order->qty > order->peak_qty) {
+            order->reserve_qty += order->qty - order->peak_qty;
+            order->qty = order->peak_qty;
+        }
+    }
+
+    // FOK pre-check: is qty available on the opposite side up to the limit?
+    // Visits only active levels, from the touch outwards, reading each
+    // level's aggregate instead of walking its queue.
+    static bool canFill(const OrderBook& book, uint32_t limit, uint32_t qty, bool is_buy) {
+        uint64_t available = 0;
+        if (is_buy) {
+            uint32_t p = book.ask_tracker_.getNextAtOrAbove(0);
+            while (p <= limit) {
+                available += book.asks_[p].total_qty + book.asks_[p].hidden_qty;
+                if (available >= qty) return true;
+                p = book.ask_tracker_.getNextAtOrAbove(p + 1);
+            }
+        } else {
+            uint32_t p = book.bid_tracker_.getNextAtOrBelow(MAX_PRICE_TICKS - 1);
+            while (p != MAX_PRICE_TICKS && p >= limit) {
+                available += book.bids_[p].total_qty + book.bids_[p].hidden_qty;
+                if (available >= qty) return true;
+                if (p == 0) break;
+                p = book.bid_tracker_.getNextAtOrBelow(p - 1);
             }
+        }
+        return false;
+    }
+
+    void matchBuyOrder(Instrument& inst, Order* inbound) {
+        OrderBook& book = inst.book;
+        while (inbound->qty > 0 && !book.ask_tracker_.isEmpty()) {
+            uint32_t best_ask = book.ask_tracker_.getBestAsk();
+            if (best_ask > inbound->price) break;
 
-            executeTrade(inbound, resting, best_ask_level, book_.best_ask_);
+            matchLevel(inst, inbound, book.asks_[best_ask], best_ask, false);
         }
     }
 
-    void matchSellOrder(Order* inbound) {
-        while (inbound->qty > 0 && book_.best_bid_ >= inbound->price) {
-            PriceLevel& best_bid_level = book_.bids_[book_.best_bid_];
-            Order* resting = best_bid_level.head;
+    void matchSellOrder(Instrument& inst, Order* inbound) {
+        OrderBook& book = inst.book;
+        while (inbound->qty > 0 && !book.bid_tracker_.isEmpty()) {
+            uint32_t best_bid = book.bid_tracker_.getBestBid();
+            if (best_bid < inbound->price) break;
+
+            matchLevel(inst, inbound, book.bids_[best_bid], best_bid, true);
+        }
+    }
 
-            if (!resting) {
-                book_.updateBestBid();
-                continue;
+    // Let the policy allocate the aggressor across one level. Self-trade
+    // prevention is checked per allocation, one owner compare each.
+    void matchLevel(Instrument& inst, Order* inbound, PriceLevel& level, uint32_t price, bool is_bid_book) {
+        policy_.match(level, inbound->qty, [&](Order* resting, uint32_t qty) {
+            if (resting->owner == inbound->owner && inbound->stp != StpMode::None) {
+                preventSelfTrade(inst, inbound, resting);
+            } else {
+                executeTrade(inst, inbound, resting, level, price, qty, is_bid_book);
             }
+            return inbound->qty;
+        });
+    }
+
+    // The aggressor met its own resting order: apply its STP mode instead of
+    // trading. The aggressor is not on any book yet, so cancelling it only
+    // reports the cancel and zeroes its qty for enter() to drop.
+    void preventSelfTrade(Instrument& inst, Order* inbound, Order* resting) {
+        StpMode mode = inbound->stp;
+        bool cancel_resting = (mode != StpMode::CancelAggressor);
+        bool cancel_aggressor = (mode != StpMode::CancelResting);
+
+        if (mode == StpMode::DecrementAndCancel) {
+            uint32_t resting_open = resting->qty + resting->reserve_qty;
+            uint32_t cut = std::min(inbound->qty, resting_open);
+            cancel_resting = (cut == resting_open);
+            cancel_aggressor = (cut == inbound->qty);
+            if (!cancel_resting) {
+                reduceResting(inst, resting, cut);
+                listener_.onModify(*resting, resting_open);
+            }
+            if (!cancel_aggressor) inbound->qty -= cut;
+        }
 
-            executeTrade(inbound, resting, best_bid_level, book_.best_bid_);
+        if (cancel_resting) {
+            index_.erase(resting->id);
+            cancelOrder(resting, CancelReason::SelfTrade);
+        }
+        if (cancel_aggressor) {
+            listener_.onCancel(*inbound, CancelReason::SelfTrade);
+            inbound->qty = 0;
         }
     }
 
-    void executeTrade(Order* inbound, Order* resting, PriceLevel& level, uint32_t fill_price) {
-        uint32_t traded_qty = std::min(inbound->qty, resting->qty);
-        
+    void executeTrade(Instrument& inst, Order* inbound, Order* resting, PriceLevel& level,
+                      uint32_t fill_price, uint32_t traded_qty, bool is_bid_book) {
+
         inbound->qty -= traded_qty;
         resting->qty -= traded_qty;
+        level.reduceQty(traded_qty);
         trades_executed_++;
+        inst.last_trade_price = fill_price;
+        listener_.onTrade(*inbound, *resting, fill_price, traded_qty);
 
         // Partial fill handling: If resting order is filled, remove and deallocate
         if (resting->qty == 0) {
-            level.pop_front();
-            if (!level.head) {
-                if (fill_price == book_.best_ask_) {
-                    book_.updateBestAsk();
-                } else if (fill_price == book_.best_bid_) {
-                    book_.updateBestBid();
+            level.unlink(resting);
+
+            // Iceberg slice consumed: refill from reserve and requeue at the
+            // back of the level, reusing the same pool slot and index entry
+            if (resting->reserve_qty > 0) {
+                resting->qty = std::min(resting->peak_qty, resting->reserve_qty);
+                resting->reserve_qty -= resting->qty;
+                level.addOrder(resting);
+                listener_.onReplenish(*resting);
+                return;
+            }
+
+            index_.erase(resting->id);
+            timers_.cancel(resting);
+            if (level.isEmpty()) {
+                if (is_bid_book) {
+                    inst.book.bid_tracker_.clearPriceLevel(fill_price);
+                } else {
+                    inst.book.ask_tracker_.clearPriceLevel(fill_price);
                 }
             }
-            pool_.deallocate(resting);
+            inst.pool->deallocate(resting);
         }
     }
-};
\ No newline at end of file
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef MBOFEED_H
+#define MBOFEED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "EngineListener.h"
+#include "SpscQueue.h"
+#include "Types.h"
+
+// ITCH-style market-by-order feed.
+//
+// Every change to the visible book becomes one fixed-length MboMessage:
+// order id, side, price and the displayed quantity left at that id, so a
+// consumer can rebuild the full order-level book. Only displayed quantity
+// is published; iceberg reserve and parked stops never appear. The matching
+// thread writes messages into an SPSC ring; a publisher thread drains it
+// into MoldUDP64-style packets (a header carrying the sequence number of
+// the first message, then messages back to back).
+
+enum class MboType : char {
+    Add = 'A',      // Order now resting with remaining_qty displayed
+    Execute = 'E',  // qty traded against this resting order
+    Delete = 'D',   // Order left the book (cancel, expiry, replace, STP)
+    Replace = 'U',  // Displayed size reduced in place; priority kept
+};
+
+#pragma pack(push, 1)
+
+struct MboMessage {
+    MboType type;
+    char side;                 // 'B' or 'S'
+    uint32_t instrument;
+    uint64_t order_id;
+    uint32_t price;
+    uint32_t qty;              // Added, executed, deleted or new displayed qty
+    uint32_t remaining_qty;    // Displayed qty left at order_id after this event
+};
+
+struct MboPacketHeader {
+    uint64_t session;
+    uint64_t sequence;         // Sequence number of the first message
+    uint16_t count;            // Messages that follow the header
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(MboMessage) == 26, "MboMessage is a fixed-length wire message");
+
+constexpr size_t MBO_QUEUE_CAPACITY = 65536;
+constexpr size_t MBO_MAX_PACKET_BYTES = 1400; // Fits an Ethernet MTU with UDP/IP headers
+using MboQueue = SpscQueue<MboMessage, MBO_QUEUE_CAPACITY>;
+
+// Listener that maps engine events onto book events. An aggressor's own
+// events are not book changes until its remainder rests (onAdd). A fully
+// executed iceberg slice is followed by an Add of the refilled slice under
+// the same id at the back of the level. A priority-losing replace is a
+// Delete, any executions as an aggressor, then an Add.
+class MboFeedListener : public NullListener {
+private:
+    MboQueue* queue_;
+
+    void publish(MboType type, const Order& order, uint32_t price, uint32_t qty, uint32_t remaining) {
+        MboMessage* slot;
+        while (!(slot = queue_->claim())) {
+            // Backpressure: the feed publisher is a full ring behind
+        }
+        *slot = MboMessage{type, order.is_buy ? 'B' : 'S', order.instrument, order.id, price, qty, remaining};
+        queue_->commit();
+    }
+
+public:
+    explicit MboFeedListener(MboQueue* queue) : queue_(queue) {}
+
+    void onAdd(const Order& order) {
+        if (order.state != OrderState::Resting) return;
+        publish(MboType::Add, order, order.price, order.qty, order.qty);
+    }
+
+    void onTrade(const Order&, const Order& resting, uint32_t price, uint32_t qty) {
+        publish(MboType::Execute, resting, price, qty, resting.qty);
+    }
+
+    void onReplenish(const Order& order) { publish(MboType::Add, order, order.price, order.qty, order.qty); }
+
+    void onCancel(const Order& order, CancelReason) {
+        if (order.state != OrderState::Resting) return;
+        publish(MboType::Delete, order, order.price, order.qty, 0);
+    }
+
+    // Reductions come out of the reserve first; while any is left the
+    // displayed slice is unchanged and there is nothing to publish
+    void onModify(const Order& order, uint32_t) {
+        if (order.reserve_qty > 0) return;
+        publish(MboType::Replace, order, order.price, order.qty, order.qty);
+    }
+};
+
+// Publisher side: drains the ring into packets. Messages are popped straight
+// into the packet buffer, and a packet goes out when it is full or the ring
+// has run dry, so a quiet book never holds a message back for batching.
+class MboPacketizer {
+    static constexpr size_t MAX_MESSAGES = (MBO_MAX_PACKET_BYTES - sizeof(MboPacketHeader)) / sizeof(MboMessage);
+
+private:
+    MboQueue* queue_;
+    uint64_t session_;
+    uint64_t next_sequence_ = 1;
+    uint64_t packets_sent_ = 0;
+    alignas(64) char packet_[sizeof(MboPacketHeader) + MAX_MESSAGES * sizeof(MboMessage)];
+
+    MboMessage* body() { return reinterpret_cast<MboMessage*>(packet_ + sizeof(MboPacketHeader)); }
+
+public:
+    MboPacketizer(MboQueue* queue, uint64_t session) : queue_(queue), session_(session) {}
+
+    // Send every queued message, as few packets as possible, through
+    // send(const char* data, size_t len). Returns the messages sent.
+    template <typename Send>
+    size_t poll(Send&& send) {
+        size_t total = 0;
+        while (size_t n = queue_->popN(body(), MAX_MESSAGES)) {
+            MboPacketHeader header{session_, next_sequence_, static_cast<uint16_t>(n)};
+            std::memcpy(packet_, &header, sizeof(header));
+            send(static_cast<const char*>(packet_), sizeof(MboPacketHeader) + n * sizeof(MboMessage));
+
+            next_sequence_ += n;
+            ++packets_sent_;
+            total += n;
+        }
+        return total;
+    }
+
+    uint64_t nextSequence() const { return next_sequence_; }
+    uint64_t packetsSent() const { return packets_sent_; }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef MPSCINGRESS_H
+#define MPSCINGRESS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include "SpscQueue.h"
+
+// Bounded multi-producer ingress for one matching thread.
+//
+// Every producer (gateway thread) owns a private SpscQueue lane, so producers
+// never contend with each other and a push is the plain SPSC fast path. The
+// consumer polls the lanes round-robin and takes at most Quota messages from
+// a lane per visit. That bounds unfairness: once a message is at the front
+// of its lane, at most (lanes - 1) * Quota messages from other lanes are
+// served before it. A full lane only pushes back on its own producer.
+template <typename T, size_t LaneCapacity, size_t MaxLanes, size_t Quota = 32>
+class MpscIngress {
+private:
+    struct Lane {
+        SpscQueue<T, LaneCapacity> queue;
+        alignas(64) std::atomic<uint64_t> rejected{0};  // Pushes refused because the lane was full (producer-written)
+        alignas(64) std::atomic<uint64_t> delivered{0}; // Messages handed to the consumer (consumer-written)
+    };
+
+    std::array<std::unique_ptr<Lane>, MaxLanes> lanes_;
+    size_t lane_count_;
+
+    // Single-writer counters: a relaxed load/store pair, no locked RMW
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+public:
+    explicit MpscIngress(size_t lanes) : lane_count_(lanes) {
+        if (lanes == 0 || lanes > MaxLanes) throw std::runtime_error("MpscIngress lane count out of range");
+        for (size_t i = 0; i < lanes; ++i) lanes_[i] = std::make_unique<Lane>();
+    }
+
+    size_t laneCount() const { return lane_count_; }
+
+    // --- Producer side: lane i belongs to exactly one producer thread ---
+
+    bool tryPush(size_t lane, const T& item) {
+        Lane& l = *lanes_[lane];
+        if (l.queue.push(item)) return true;
+        bump(l.rejected);
+        return false;
+    }
+
+    // Zero-copy produce into the lane's next slot; nullptr (and a
+    // backpressure count) if the lane is full
+    T* claim(size_t lane) {
+        Lane& l = *lanes_[lane];
+        T* slot = l.queue.claim();
+        if (!slot) bump(l.rejected);
+        return slot;
+    }
+
+    void commit(size_t lane) { lanes_[lane]->queue.commit(); }
+
+    // --- Consumer side ---
+
+    // One round-robin sweep: up to Quota messages from each lane in turn.
+    // Returns how many messages were handed to handler(const T&, size_t lane).
+    template <typename Handler>
+    size_t poll(Handler&& handler) {
+        T batch[Quota];
+        size_t total = 0;
+        for (size_t lane = 0; lane < lane_count_; ++lane) {
+            Lane& l = *lanes_[lane];
+            size_t n = l.queue.popN(batch, Quota);
+            for (size_t i = 0; i < n; ++i) handler(static_cast<const T&>(batch[i]), lane);
+            if (n) bump(l.delivered, n);
+            total += n;
+        }
+        return total;
+    }
+
+    // Counters are safe to read from any thread
+    uint64_t rejected(size_t lane) const { return lanes_[lane]->rejected.load(std::memory_order_relaxed); }
+    uint64_t delivered(size_t lane) const { return lanes_[lane]->delivered.load(std::memory_order_relaxed); }
+};
+
+#endif
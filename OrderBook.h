@@ -1,20 +1,35 @@
 #ifndef ORDERBOOK_H
 #define ORDERBOOK_H
 
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <array>
 #include "Types.h"
 
-// Support for 4096 price ticks (64 blocks of 64 bits)
-
 struct Order; // Forward declaration
 
+// One row of a depth snapshot
+struct DepthLevel {
+    uint32_t price;
+    uint64_t qty;           // Displayed
+    uint32_t order_count;
+};
+
 struct PriceLevel {
     Order* head = nullptr;
     Order* tail = nullptr;
+    // Aggregates maintained incrementally so depth reads never walk the list
+    uint64_t total_qty = 0;     // Displayed
+    uint64_t hidden_qty = 0;    // Iceberg reserves behind the displayed slices
+    uint32_t order_count = 0;
+
+    bool isEmpty() const { return head == nullptr; }
     
     void addOrder(Order* order) {
+        total_qty += order->qty;
+        hidden_qty += order->reserve_qty;
+        order_count++;
         order->prev = tail;
         order->next = nullptr;
         if (tail) {
@@ -28,6 +43,9 @@ struct PriceLevel {
     void pop_front() {
         if (!head) return;
         Order* old_head = head;
+        total_qty -= old_head->qty;
+        hidden_qty -= old_head->reserve_qty;
+        order_count--;
         head = head->next;
         if (head) {
             head->prev = nullptr;
@@ -37,45 +55,83 @@ struct PriceLevel {
         old_head->next = nullptr;
         old_head->prev = nullptr;
     }
+
+    // O(1) removal from anywhere in the queue via the intrusive pointers
+    void unlink(Order* order) {
+        total_qty -= order->qty;
+        hidden_qty -= order->reserve_qty;
+        order_count--;
+        if (order->prev) {
+            order->prev->next = order->next;
+        } else {
+            head = order->next;
+        }
+        if (order->next) {
+            order->next->prev = order->prev;
+        } else {
+            tail = order->prev;
+        }
+        order->next = nullptr;
+        order->prev = nullptr;
+    }
+
+    // A resting order lost qty in place (partial fill, size reduction)
+    void reduceQty(uint32_t qty, uint32_t reserve_qty = 0) {
+        total_qty -= qty;
+        hidden_qty -= reserve_qty;
+    }
 };
 
+// Three-level hierarchical bitset: summary -> mid -> leaf, 1 bit per price tick.
+// Sized from MAX_PRICE_TICKS at compile time; covers up to 64^3 = 262,144 ticks.
 class FastPriceTracker {
+public:
+    static constexpr uint32_t LEAF_WORDS = (MAX_PRICE_TICKS + 63) / 64;
+    static constexpr uint32_t MID_WORDS = (LEAF_WORDS + 63) / 64;
+    static_assert(MID_WORDS <= 64, "MAX_PRICE_TICKS exceeds the 262,144 ticks a 3-level tracker can cover");
+
 private:
-    uint64_t summary_word_ = 0;           // 1 bit per data_word_
-    uint64_t data_words_[64] = {0};       // 1 bit per price tick
+    uint64_t summary_word_ = 0;               // 1 bit per mid word
+    uint64_t mid_words_[MID_WORDS] = {0};     // 1 bit per leaf word
+    uint64_t leaf_words_[LEAF_WORDS] = {0};   // 1 bit per price tick
 
 public:
-    // Mark a price level as active (O(1) - Bitwise OR)
+    // Mark a price level as active (O(1) - Bitwise OR at each level)
     void setPriceLevel(uint32_t price) {
-        uint32_t word_idx = price / 64;
-        uint32_t bit_idx = price % 64;
-        
-        data_words_[word_idx] |= (1ULL << bit_idx);
-        summary_word_ |= (1ULL << word_idx);
+        uint32_t leaf_idx = price / 64;
+        uint32_t mid_idx = leaf_idx / 64;
+
+        leaf_words_[leaf_idx] |= (1ULL << (price % 64));
+        mid_words_[mid_idx] |= (1ULL << (leaf_idx % 64));
+        summary_word_ |= (1ULL << mid_idx);
     }
 
     // Mark a price level as empty (O(1) - Bitwise AND NOT)
     void clearPriceLevel(uint32_t price) {
-        uint32_t word_idx = price / 64;
-        uint32_t bit_idx = price % 64;
-        
-        data_words_[word_idx] &= ~(1ULL << bit_idx);
-        
-        // If the data word is completely empty, update the summary
-        if (data_words_[word_idx] == 0) {
-            summary_word_ &= ~(1ULL << word_idx);
-        }
+        uint32_t leaf_idx = price / 64;
+        uint32_t mid_idx = leaf_idx / 64;
+
+        leaf_words_[leaf_idx] &= ~(1ULL << (price % 64));
+
+        // Only propagate upwards when a whole word has drained
+        if (leaf_words_[leaf_idx] != 0) return;
+        mid_words_[mid_idx] &= ~(1ULL << (leaf_idx % 64));
+
+        if (mid_words_[mid_idx] != 0) return;
+        summary_word_ &= ~(1ULL << mid_idx);
     }
 
+    bool isEmpty() const { return summary_word_ == 0; }
+
     // O(1) lookup for the Best Ask (Lowest active price)
     uint32_t getBestAsk() const {
         if (summary_word_ == 0) return MAX_PRICE_TICKS; // Book is empty
         
         // __builtin_ctzll counts trailing zeros (finds the LOWEST set bit)
-        uint32_t lowest_active_word = __builtin_ctzll(summary_word_);
-        uint32_t lowest_active_bit = __builtin_ctzll(data_words_[lowest_active_word]);
+        uint32_t mid_idx = __builtin_ctzll(summary_word_);
+        uint32_t leaf_idx = (mid_idx * 64) + __builtin_ctzll(mid_words_[mid_idx]);
         
-        return (lowest_active_word * 64) + lowest_active_bit;
+        return (leaf_idx * 64) + __builtin_ctzll(leaf_words_[leaf_idx]);
     }
 
     // O(1) lookup for the Best Bid (Highest active price)
@@ -84,10 +140,53 @@ public:
         
         // __builtin_clzll counts leading zeros. 
         // 63 - clzll finds the HIGHEST set bit.
-        uint32_t highest_active_word = 63 - __builtin_clzll(summary_word_);
-        uint32_t highest_active_bit = 63 - __builtin_clzll(data_words_[highest_active_word]);
+        uint32_t mid_idx = 63 - __builtin_clzll(summary_word_);
+        uint32_t leaf_idx = (mid_idx * 64) + (63 - __builtin_clzll(mid_words_[mid_idx]));
         
-        return (highest_active_word * 64) + highest_active_bit;
+        return (leaf_idx * 64) + (63 - __builtin_clzll(leaf_words_[leaf_idx]));
+    }
+
+    // Lowest active price >= price, or MAX_PRICE_TICKS if none.
+    // Masks off the bits below the start point at each level, then ctz.
+    uint32_t getNextAtOrAbove(uint32_t price) const {
+        if (price >= MAX_PRICE_TICKS) return MAX_PRICE_TICKS;
+        uint32_t leaf_idx = price / 64;
+        uint64_t leaf = leaf_words_[leaf_idx] & (~0ULL << (price % 64));
+        if (leaf) return (leaf_idx * 64) + __builtin_ctzll(leaf);
+
+        uint32_t mid_idx = leaf_idx / 64;
+        uint32_t mid_bit = (leaf_idx % 64) + 1;
+        uint64_t mid = (mid_bit < 64) ? (mid_words_[mid_idx] & (~0ULL << mid_bit)) : 0;
+        if (!mid) {
+            uint32_t summary_bit = mid_idx + 1;
+            uint64_t summary = (summary_bit < 64) ? (summary_word_ & (~0ULL << summary_bit)) : 0;
+            if (!summary) return MAX_PRICE_TICKS;
+            mid_idx = __builtin_ctzll(summary);
+            mid = mid_words_[mid_idx];
+        }
+        leaf_idx = (mid_idx * 64) + __builtin_ctzll(mid);
+        return (leaf_idx * 64) + __builtin_ctzll(leaf_words_[leaf_idx]);
+    }
+
+    // Highest active price <= price, or MAX_PRICE_TICKS if none.
+    // Masks off the bits above the start point at each level, then clz.
+    uint32_t getNextAtOrBelow(uint32_t price) const {
+        if (price >= MAX_PRICE_TICKS) price = MAX_PRICE_TICKS - 1;
+        uint32_t leaf_idx = price / 64;
+        uint64_t leaf = leaf_words_[leaf_idx] & (~0ULL >> (63 - (price % 64)));
+        if (leaf) return (leaf_idx * 64) + (63 - __builtin_clzll(leaf));
+
+        uint32_t mid_idx = leaf_idx / 64;
+        uint32_t mid_bit = leaf_idx % 64;
+        uint64_t mid = mid_bit ? (mid_words_[mid_idx] & (~0ULL >> (64 - mid_bit))) : 0;
+        if (!mid) {
+            uint64_t summary = mid_idx ? (summary_word_ & (~0ULL >> (64 - mid_idx))) : 0;
+            if (!summary) return MAX_PRICE_TICKS;
+            mid_idx = 63 - __builtin_clzll(summary);
+            mid = mid_words_[mid_idx];
+        }
+        leaf_idx = (mid_idx * 64) + (63 - __builtin_clzll(mid));
+        return (leaf_idx * 64) + (63 - __builtin_clzll(leaf_words_[leaf_idx]));
     }
 };
 
@@ -95,42 +194,62 @@ class OrderBook {
 public:
     std::array<PriceLevel, MAX_PRICE_TICKS> asks_;
     std::array<PriceLevel, MAX_PRICE_TICKS> bids_;
-    uint32_t best_ask_ = MAX_PRICE_TICKS;
-    uint32_t best_bid_ = 0;
+    FastPriceTracker ask_tracker_;
+    FastPriceTracker bid_tracker_;
 
 public:
     void addOrder(Order* order) {
         if (order->is_buy) {
+            if (bids_[order->price].isEmpty()) bid_tracker_.setPriceLevel(order->price);
             bids_[order->price].addOrder(order);
-            if (order->price > best_bid_) {
-                best_bid_ = order->price;
-            }
         } else {
+            if (asks_[order->price].isEmpty()) ask_tracker_.setPriceLevel(order->price);
             asks_[order->price].addOrder(order);
-            if (order->price < best_ask_) {
-                best_ask_ = order->price;
-            }
         }
     }
 
-    void updateBestAsk() {
-        for (uint32_t i = 0; i < MAX_PRICE_TICKS; ++i) {
-            if (asks_[i].head) {
-                best_ask_ = i;
-                return;
+    PriceLevel& getLevel(bool is_buy, uint32_t price) {
+        return is_buy ? bids_[price] : asks_[price];
+    }
+
+    const PriceLevel& getLevel(bool is_buy, uint32_t price) const {
+        return is_buy ? bids_[price] : asks_[price];
+    }
+
+    // Copy up to n active levels of one side into out, best price first,
+    // and return how many were written. Each step is one tracker lookup, so
+    // the cost is O(n) however sparse the ladder between levels is.
+    size_t getDepth(bool is_buy, size_t n, DepthLevel* out) const {
+        size_t count = 0;
+        if (is_buy) {
+            uint32_t p = bid_tracker_.getNextAtOrBelow(MAX_PRICE_TICKS - 1);
+            while (count < n && p != MAX_PRICE_TICKS) {
+                const PriceLevel& level = bids_[p];
+                out[count++] = DepthLevel{p, level.total_qty, level.order_count};
+                if (p == 0) break;
+                p = bid_tracker_.getNextAtOrBelow(p - 1);
+            }
+        } else {
+            uint32_t p = ask_tracker_.getNextAtOrAbove(0);
+            while (count < n && p != MAX_PRICE_TICKS) {
+                const PriceLevel& level = asks_[p];
+                out[count++] = DepthLevel{p, level.total_qty, level.order_count};
+                p = ask_tracker_.getNextAtOrAbove(p + 1);
             }
         }
-        best_ask_ = MAX_PRICE_TICKS;
+        return count;
     }
 
-    void updateBestBid() {
-        for (uint32_t i = MAX_PRICE_TICKS; i > 0; --i) {
-            if (bids_[i-1].head) {
-                best_bid_ = i-1;
-                return;
-            }
+    void removeOrder(Order* order) {
+        if (order->is_buy) {
+            PriceLevel& level = bids_[order->price];
+            level.unlink(order);
+            if (level.isEmpty()) bid_tracker_.clearPriceLevel(order->price);
+        } else {
+            PriceLevel& level = asks_[order->price];
+            level.unlink(order);
+            if (level.isEmpty()) ask_tracker_.clearPriceLevel(order->price);
         }
-        best_bid_ = 0;
     }
 };
 
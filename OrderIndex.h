@@ -0,0 +1,93 @@
+#ifndef ORDERINDEX_H
+#define ORDERINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "Types.h"
+
+// Open-addressing id -> Order* index for resting orders.
+// Linear probing with backward-shift deletion: no tombstones, so probe
+// chains never degrade under the cancel-heavy churn of real order flow.
+class OrderIndex {
+private:
+    struct Slot {
+        uint64_t id;
+        Order* order;   // nullptr marks an empty slot
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    uint32_t bits_;
+
+    // XOR-fold the id onto the table width. Sequential ids land in adjacent
+    // slots (cache- and TLB-friendly), while the folded high bits still
+    // spread sparse or strided client ids.
+    size_t home(uint64_t id) const {
+        uint64_t h = id;
+        for (uint32_t s = bits_; s < 64; s += bits_) h ^= id >> s;
+        return static_cast<size_t>(h) & mask_;
+    }
+
+public:
+    // Sized to at least twice the live order count so the load factor stays
+    // under 50%; allocated once at startup, never resized.
+    explicit OrderIndex(size_t max_orders = MAX_ORDERS) {
+        size_t capacity = 2;
+        uint32_t bits = 1;
+        while (capacity < max_orders * 2) {
+            capacity <<= 1;
+            ++bits;
+        }
+        slots_.assign(capacity, Slot{0, nullptr});
+        mask_ = capacity - 1;
+        bits_ = bits;
+    }
+
+    // Returns false if the id is already live
+    bool insert(uint64_t id, Order* order) {
+        size_t i = home(id);
+        while (slots_[i].order) {
+            if (slots_[i].id == id) return false;
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = Slot{id, order};
+        return true;
+    }
+
+    Order* find(uint64_t id) const {
+        size_t i = home(id);
+        while (slots_[i].order) {
+            if (slots_[i].id == id) return slots_[i].order;
+            i = (i + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    // Removes and returns the order, or nullptr if the id is unknown
+    Order* erase(uint64_t id) {
+        size_t i = home(id);
+        while (slots_[i].order) {
+            if (slots_[i].id == id) break;
+            i = (i + 1) & mask_;
+        }
+        Order* erased = slots_[i].order;
+        if (!erased) return nullptr;
+
+        // Backward-shift: pull later entries of the cluster into the hole
+        // whenever the hole lies between their home slot and where they sit.
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask_;
+            if (!slots_[j].order) break;
+            size_t h = home(slots_[j].id);
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i].order = nullptr;
+        return erased;
+    }
+};
+
+#endif
\ No newline at end of file
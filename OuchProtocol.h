@@ -0,0 +1,233 @@
+#ifndef OUCHPROTOCOL_H
+#define OUCHPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "ExecReport.h"
+#include "Types.h"
+
+// OUCH-style fixed-length binary order-entry protocol.
+//
+// Every message starts with a one-byte type that fixes its length, so a
+// stream is framed without length prefixes or delimiters. Fields are packed,
+// unaligned and little-endian (the engine's host order), so decoding a field
+// is a single unaligned load. The packed structs below only document the
+// layout: the decoder reads each field at its offsetof() straight from the
+// receive buffer and never materialises a message object.
+
+#pragma pack(push, 1)
+
+// --- Inbound (client -> engine) ---
+
+struct OuchEnterOrder {
+    char type;              // 'O'
+    uint64_t order_id;
+    uint32_t instrument;
+    char side;              // 'B' or 'S'
+    uint32_t qty;
+    uint32_t price;
+    uint32_t display_qty;   // Iceberg peak, 0 shows the full qty
+    uint32_t stop_price;
+    uint32_t owner;
+    uint8_t order_type;     // OrderType
+    uint8_t tif;            // TimeInForce
+    uint8_t stp;            // StpMode
+    uint64_t expire_time;   // GTD only
+};
+
+struct OuchCancelOrder {
+    char type;              // 'X'
+    uint64_t order_id;
+};
+
+struct OuchReplaceOrder {
+    char type;              // 'U'
+    uint64_t order_id;
+    uint32_t price;
+    uint32_t qty;           // New open qty
+};
+
+struct OuchMassCancel {
+    char type;              // 'M'
+    uint32_t owner;
+    uint32_t instrument;    // ALL_INSTRUMENTS for every book
+};
+
+// --- Outbound (engine -> client) ---
+
+struct OuchAccepted {
+    char type;              // 'A': rested, or stop parked
+    uint64_t order_id;
+    uint32_t instrument;
+    uint32_t price;
+    uint32_t qty;           // Open qty incl. iceberg reserve
+    char side;
+};
+
+struct OuchExecuted {
+    char type;              // 'E': one per side of each fill
+    uint64_t order_id;
+    uint64_t contra_id;
+    uint32_t instrument;
+    uint32_t price;
+    uint32_t qty;
+    uint32_t leaves_qty;
+    char liquidity;         // 'R' removed (aggressor), 'A' added (resting)
+};
+
+struct OuchCanceled {
+    char type;              // 'C'
+    uint64_t order_id;
+    uint32_t instrument;
+    uint32_t qty;           // Open qty cancelled
+    uint8_t reason;         // CancelReason
+};
+
+struct OuchReplaced {
+    char type;              // 'R': size reduced in place, priority kept
+    uint64_t order_id;
+    uint32_t instrument;
+    uint32_t price;
+    uint32_t qty;
+};
+
+struct OuchRejected {
+    char type;              // 'J': no instrument, a reject may not name a valid one
+    uint64_t order_id;
+    uint8_t reason;         // RejectReason
+};
+
+#pragma pack(pop)
+
+// Largest outbound encoding of one ExecReport (a fill is two executions)
+constexpr size_t OUCH_MAX_REPORT_BYTES = 2 * sizeof(OuchExecuted);
+
+// Streaming decoder: parses every complete message in a receive buffer and
+// calls the engine directly. Engine is any MatchingEngine instantiation.
+class OuchDecoder {
+private:
+    bool malformed_ = false;
+
+    template <typename T>
+    static T load(const char* p, size_t offset) {
+        T value;
+        std::memcpy(&value, p + offset, sizeof(T));
+        return value;
+    }
+
+    // Wire length of a message type, 0 if unknown
+    static size_t messageLength(char type) {
+        switch (type) {
+            case 'O': return sizeof(OuchEnterOrder);
+            case 'X': return sizeof(OuchCancelOrder);
+            case 'U': return sizeof(OuchReplaceOrder);
+            case 'M': return sizeof(OuchMassCancel);
+            default: return 0;
+        }
+    }
+
+    template <typename Engine>
+    bool enterOrder(const char* m, Engine& engine) {
+        char side = load<char>(m, offsetof(OuchEnterOrder, side));
+        uint8_t type = load<uint8_t>(m, offsetof(OuchEnterOrder, order_type));
+        uint8_t tif = load<uint8_t>(m, offsetof(OuchEnterOrder, tif));
+        uint8_t stp = load<uint8_t>(m, offsetof(OuchEnterOrder, stp));
+        if ((side != 'B' && side != 'S') || type > static_cast<uint8_t>(OrderType::StopLimit) ||
+            tif > static_cast<uint8_t>(TimeInForce::GTD) || stp > static_cast<uint8_t>(StpMode::DecrementAndCancel)) {
+            return false;
+        }
+
+        engine.processNewOrder(load<uint64_t>(m, offsetof(OuchEnterOrder, order_id)),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, price)),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, qty)),
+                               side == 'B',
+                               static_cast<OrderType>(type),
+                               static_cast<TimeInForce>(tif),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, display_qty)),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, stop_price)),
+                               load<uint64_t>(m, offsetof(OuchEnterOrder, expire_time)),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, owner)),
+                               static_cast<StpMode>(stp),
+                               load<uint32_t>(m, offsetof(OuchEnterOrder, instrument)));
+        return true;
+    }
+
+public:
+    // Decode as many whole messages as len holds. Returns the bytes consumed;
+    // a trailing partial message is left for the caller to carry over into
+    // the next read. An unknown type or out-of-range enum stops decoding and
+    // sets malformed() (the session should be dropped).
+    template <typename Engine>
+    size_t decode(const char* data, size_t len, Engine& engine) {
+        size_t pos = 0;
+        while (pos < len) {
+            const char* m = data + pos;
+            size_t msg_len = messageLength(*m);
+            if (msg_len == 0) {
+                malformed_ = true;
+                return pos;
+            }
+            if (len - pos < msg_len) break;
+
+            switch (*m) {
+                case 'O':
+                    if (!enterOrder(m, engine)) {
+                        malformed_ = true;
+                        return pos;
+                    }
+                    break;
+                case 'X':
+                    engine.processCancel(load<uint64_t>(m, offsetof(OuchCancelOrder, order_id)));
+                    break;
+                case 'U':
+                    engine.processModify(load<uint64_t>(m, offsetof(OuchReplaceOrder, order_id)),
+                                         load<uint32_t>(m, offsetof(OuchReplaceOrder, price)),
+                                         load<uint32_t>(m, offsetof(OuchReplaceOrder, qty)));
+                    break;
+                case 'M':
+                    engine.processMassCancel(load<uint32_t>(m, offsetof(OuchMassCancel, owner)),
+                                             load<uint32_t>(m, offsetof(OuchMassCancel, instrument)));
+                    break;
+            }
+            pos += msg_len;
+        }
+        return pos;
+    }
+
+    bool malformed() const { return malformed_; }
+};
+
+// Encode one ExecReport as outbound OUCH message(s) into out, which must
+// have OUCH_MAX_REPORT_BYTES free. Returns the bytes written; Triggered has
+// no OUCH message (the fills that follow report it).
+inline size_t encodeOuchReport(const ExecReport& report, char* out) {
+    auto put = [](char* p, const auto& msg) {
+        std::memcpy(p, &msg, sizeof(msg));
+        return sizeof(msg);
+    };
+
+    switch (report.type) {
+        case ExecType::Added:
+            return put(out, OuchAccepted{'A', report.order_id, report.instrument, report.price, report.qty,
+                                         report.is_buy ? 'B' : 'S'});
+        case ExecType::Filled: {
+            size_t n = put(out, OuchExecuted{'E', report.order_id, report.contra_id, report.instrument,
+                                             report.price, report.qty, report.leaves_qty, 'R'});
+            return n + put(out + n, OuchExecuted{'E', report.contra_id, report.order_id, report.instrument,
+                                                 report.price, report.qty, report.contra_leaves_qty, 'A'});
+        }
+        case ExecType::Cancelled:
+            return put(out, OuchCanceled{'C', report.order_id, report.instrument, report.qty,
+                                         static_cast<uint8_t>(report.reason)});
+        case ExecType::Modified:
+            return put(out, OuchReplaced{'R', report.order_id, report.instrument, report.price, report.qty});
+        case ExecType::Rejected:
+            return put(out, OuchRejected{'J', report.order_id, static_cast<uint8_t>(report.reject_reason)});
+        case ExecType::Triggered:
+            return 0;
+    }
+    return 0;
+}
+
+#endif
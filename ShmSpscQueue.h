@@ -0,0 +1,204 @@
+#ifndef SHMSPSCQUEUE_H
+#define SHMSPSCQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Cross-process variant of SpscQueue. The indices and the ring live in one
+// shared mapping (shm_open by name, or an inherited/passed fd such as a
+// memfd), so a gateway process and the engine process exchange messages with
+// plain loads and stores: no syscalls and no copies beyond the slot itself.
+// Use one queue per direction (orders in, responses out).
+//
+// The mapping has a fixed layout, stamped with a magic, a layout version and
+// the element size and capacity, and an opener refuses any mismatch. The
+// creator publishes the magic last, with release ordering; an opener that
+// attaches before that fails with EAGAIN and should retry, while a real
+// mismatch is EPROTO (see fail()). Each process keeps its cached view of the other
+// side's index locally.
+
+enum class ShmMode : uint8_t {
+    Create, // Create and initialise the mapping (fails if it already exists)
+    Open,   // Attach to a mapping created by another process
+};
+
+constexpr uint64_t SHM_QUEUE_MAGIC = 0x4E4D5348'4D515545ULL; // "NMSHMQUE"
+constexpr uint32_t SHM_QUEUE_VERSION = 1;
+
+template <typename T, size_t Capacity>
+class ShmSpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Shared-memory messages must be trivially copyable");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory indices must be lock-free");
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Fixed layout at offset 0 of the mapping; the ring follows at SLOTS_OFFSET
+    struct Header {
+        std::atomic<uint64_t> magic;  // Stored last by the creator, release
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t capacity;
+        alignas(64) std::atomic<uint64_t> write_idx;
+        alignas(64) std::atomic<uint64_t> read_idx;
+    };
+
+    static constexpr size_t SLOTS_OFFSET = (sizeof(Header) + 63) & ~size_t(63);
+    static constexpr size_t MAPPING_SIZE = SLOTS_OFFSET + sizeof(T) * Capacity;
+
+private:
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    Header* header_ = nullptr;
+    T* slots_ = nullptr;
+    uint64_t cached_read_idx_ = 0;   // Producer's view of read_idx
+    uint64_t cached_write_idx_ = 0;  // Consumer's view of write_idx
+
+    // A std::system_error (a runtime_error) whose code() is the errno, so an
+    // opener can tell a retryable EAGAIN from a permanent failure
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), "ShmSpscQueue: " + what);
+    }
+
+    // Failure once fd_ is open: unmap and close first, so a throwing
+    // constructor leaks nothing, but report the errno of the failed call
+    [[noreturn]] void releaseAndFail(const std::string& what) {
+        int err = errno;
+        release();
+        errno = err;
+        fail(what);
+    }
+
+    void map(ShmMode mode) {
+        if (mode == ShmMode::Create) {
+            if (ftruncate(fd_, MAPPING_SIZE) != 0) releaseAndFail("ftruncate");
+        } else {
+            // Mapping past the end of a still-growing object would SIGBUS
+            struct stat st;
+            if (fstat(fd_, &st) != 0) releaseAndFail("fstat");
+            if (static_cast<size_t>(st.st_size) < MAPPING_SIZE) {
+                errno = EAGAIN;
+                releaseAndFail("mapping not initialised yet");
+            }
+        }
+        mapping_ = mmap(nullptr, MAPPING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            releaseAndFail("mmap");
+        }
+        header_ = static_cast<Header*>(mapping_);
+        slots_ = reinterpret_cast<T*>(static_cast<char*>(mapping_) + SLOTS_OFFSET);
+
+        if (mode == ShmMode::Create) {
+            new (&header_->magic) std::atomic<uint64_t>(0);
+            new (&header_->write_idx) std::atomic<uint64_t>(0);
+            new (&header_->read_idx) std::atomic<uint64_t>(0);
+            header_->version = SHM_QUEUE_VERSION;
+            header_->element_size = sizeof(T);
+            header_->capacity = Capacity;
+            header_->magic.store(SHM_QUEUE_MAGIC, std::memory_order_release);
+            return;
+        }
+
+        // Zero magic: the creator has sized the object but not yet
+        // published the header. Anything else that disagrees is permanent.
+        const uint64_t magic = header_->magic.load(std::memory_order_acquire);
+        if (magic == 0) {
+            errno = EAGAIN;
+            releaseAndFail("mapping not initialised yet");
+        }
+        if (magic != SHM_QUEUE_MAGIC || header_->version != SHM_QUEUE_VERSION ||
+            header_->element_size != sizeof(T) || header_->capacity != Capacity) {
+            errno = EPROTO;
+            releaseAndFail("layout mismatch");
+        }
+        cached_read_idx_ = header_->read_idx.load(std::memory_order_acquire);
+        cached_write_idx_ = header_->write_idx.load(std::memory_order_acquire);
+    }
+
+    void release() {
+        if (mapping_) munmap(mapping_, MAPPING_SIZE);
+        if (fd_ >= 0) close(fd_);
+        mapping_ = nullptr;
+        fd_ = -1;
+    }
+
+public:
+    // Named POSIX shared memory ("/nanomatch-orders"); remove with unlink()
+    ShmSpscQueue(const char* name, ShmMode mode) {
+        int flags = (mode == ShmMode::Create) ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR;
+        fd_ = shm_open(name, flags, 0600);
+        if (fd_ < 0) fail(std::string("shm_open ") + name);
+        try {
+            map(mode);
+        } catch (...) {
+            // Don't leave a half-made object behind in /dev/shm
+            if (mode == ShmMode::Create) shm_unlink(name);
+            throw;
+        }
+    }
+
+    // An already-open descriptor, e.g. a memfd inherited across fork or
+    // passed over a Unix socket. Takes ownership of fd, which is closed if
+    // the constructor throws.
+    ShmSpscQueue(int fd, ShmMode mode) : fd_(fd) { map(mode); }
+
+    ~ShmSpscQueue() { release(); }
+
+    ShmSpscQueue(const ShmSpscQueue&) = delete;
+    ShmSpscQueue& operator=(const ShmSpscQueue&) = delete;
+
+    static void unlink(const char* name) { shm_unlink(name); }
+
+    // --- Producer (one process) ---
+
+    bool push(const T& item) {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    // Next slot to fill in place, or nullptr if full
+    T* claim() {
+        const uint64_t write = header_->write_idx.load(std::memory_order_relaxed);
+        if (write - cached_read_idx_ == Capacity) {
+            cached_read_idx_ = header_->read_idx.load(std::memory_order_acquire);
+            if (write - cached_read_idx_ == Capacity) return nullptr;
+        }
+        return &slots_[write & MASK];
+    }
+
+    void commit() {
+        header_->write_idx.store(header_->write_idx.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // --- Consumer (the other process) ---
+
+    bool pop(T& item) { return popN(&item, 1) == 1; }
+
+    size_t popN(T* out, size_t max_items) {
+        const uint64_t read = header_->read_idx.load(std::memory_order_relaxed);
+        if (cached_write_idx_ - read < max_items) {
+            cached_write_idx_ = header_->write_idx.load(std::memory_order_acquire);
+        }
+        size_t n = static_cast<size_t>(std::min<uint64_t>(cached_write_idx_ - read, max_items));
+        for (size_t i = 0; i < n; ++i) out[i] = slots_[(read + i) & MASK];
+        if (n) header_->read_idx.store(read + n, std::memory_order_release);
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free Single-Producer Single-Consumer ring buffer.
+//
+// Indices are free-running sequence numbers wrapped with a mask, so all
+// Capacity slots are usable. Each side keeps a private cached copy of the
+// other side's index and only reloads the shared atomic when the cache says
+// the ring is full (producer) or empty (consumer), which keeps the index
+// cache lines from bouncing between cores on every message.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr size_t MASK = Capacity - 1;
+
+private:
+    alignas(64) std::atomic<size_t> write_idx_{0};
+    alignas(64) size_t cached_read_idx_ = 0;   // Producer's view of read_idx_
+    alignas(64) std::atomic<size_t> read_idx_{0};
+    alignas(64) size_t cached_write_idx_ = 0;  // Consumer's view of write_idx_
+    alignas(64) std::array<T, Capacity> buffer_;
+
+    // Producer side: free slots, refreshing the cached read index only when
+    // the cached value cannot satisfy the request
+    size_t freeSlots(size_t write, size_t wanted) {
+        size_t free = Capacity - (write - cached_read_idx_);
+        if (free < wanted) {
+            cached_read_idx_ = read_idx_.load(std::memory_order_acquire);
+            free = Capacity - (write - cached_read_idx_);
+        }
+        return free;
+    }
+
+    // Consumer side: readable slots, same caching
+    size_t readySlots(size_t read, size_t wanted) {
+        size_t ready = cached_write_idx_ - read;
+        if (ready < wanted) {
+            cached_write_idx_ = write_idx_.load(std::memory_order_acquire);
+            ready = cached_write_idx_ - read;
+        }
+        return ready;
+    }
+
+public:
+    bool push(const T& item) {
+        const size_t write = write_idx_.load(std::memory_order_relaxed);
+        if (freeSlots(write, 1) == 0) return false;
+
+        buffer_[write & MASK] = item;
+        write_idx_.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const size_t read = read_idx_.load(std::memory_order_relaxed);
+        if (readySlots(read, 1) == 0) return false;
+
+        item = buffer_[read & MASK];
+        read_idx_.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Push up to n items with a single index publish; returns how many fit
+    size_t tryPushN(const T* items, size_t n) {
+        const size_t write = write_idx_.load(std::memory_order_relaxed);
+        n = std::min(n, freeSlots(write, n));
+        for (size_t i = 0; i < n; ++i) buffer_[(write + i) & MASK] = items[i];
+        if (n) write_idx_.store(write + n, std::memory_order_release);
+        return n;
+    }
+
+    // Pop up to max_items with a single index publish; returns how many were read
+    size_t popN(T* out, size_t max_items) {
+        const size_t read = read_idx_.load(std::memory_order_relaxed);
+        size_t n = std::min(max_items, readySlots(read, max_items));
+        for (size_t i = 0; i < n; ++i) out[i] = buffer_[(read + i) & MASK];
+        if (n) read_idx_.store(read + n, std::memory_order_release);
+        return n;
+    }
+
+    // Zero-copy produce: claim() hands out the next slot (nullptr if full)
+    // to be filled in place; commit() publishes it. At most one claim may be
+    // outstanding.
+    T* claim() {
+        const size_t write = write_idx_.load(std::memory_order_relaxed);
+        if (freeSlots(write, 1) == 0) return nullptr;
+        return &buffer_[write & MASK];
+    }
+
+    void commit() {
+        write_idx_.store(write_idx_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+#endif
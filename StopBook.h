@@ -0,0 +1,75 @@
+#ifndef STOPBOOK_H
+#define STOPBOOK_H
+
+#include <array>
+#include <cstdint>
+#include "OrderBook.h"
+#include "Types.h"
+
+// Trigger book for Stop/StopLimit orders, keyed by stop price.
+// Reuses PriceLevel for FIFO queues and FastPriceTracker for the
+// next-triggerable lookup, so electing stops never scans the stop population.
+class StopBook {
+public:
+    std::array<PriceLevel, MAX_PRICE_TICKS> buy_stops_;
+    std::array<PriceLevel, MAX_PRICE_TICKS> sell_stops_;
+    FastPriceTracker buy_tracker_;   // Lowest buy stop is the first to trigger
+    FastPriceTracker sell_tracker_;  // Highest sell stop is the first to trigger
+
+public:
+    bool isEmpty() const { return buy_tracker_.isEmpty() && sell_tracker_.isEmpty(); }
+
+    // A buy stop fires once a trade prints at or above it, a sell stop at or below
+    static bool isTriggered(const Order& order, uint32_t last_price) {
+        if (last_price == MAX_PRICE_TICKS) return false; // Nothing has traded yet
+        return order.is_buy ? order.stop_price <= last_price : order.stop_price >= last_price;
+    }
+
+    void addStop(Order* order) {
+        if (order->is_buy) {
+            if (buy_stops_[order->stop_price].isEmpty()) buy_tracker_.setPriceLevel(order->stop_price);
+            buy_stops_[order->stop_price].addOrder(order);
+        } else {
+            if (sell_stops_[order->stop_price].isEmpty()) sell_tracker_.setPriceLevel(order->stop_price);
+            sell_stops_[order->stop_price].addOrder(order);
+        }
+    }
+
+    void removeStop(Order* order) {
+        if (order->is_buy) {
+            PriceLevel& level = buy_stops_[order->stop_price];
+            level.unlink(order);
+            if (level.isEmpty()) buy_tracker_.clearPriceLevel(order->stop_price);
+        } else {
+            PriceLevel& level = sell_stops_[order->stop_price];
+            level.unlink(order);
+            if (level.isEmpty()) sell_tracker_.clearPriceLevel(order->stop_price);
+        }
+    }
+
+    // Unlinks and returns the next stop elected by last_price, or nullptr.
+    // Stops fire in trigger-price order (nearest the old market first) and in
+    // time priority within a trigger price.
+    Order* popTriggered(uint32_t last_price) {
+        if (last_price == MAX_PRICE_TICKS) return nullptr;
+        if (!buy_tracker_.isEmpty()) {
+            uint32_t stop_price = buy_tracker_.getBestAsk();
+            if (stop_price <= last_price) return popFront(buy_stops_[stop_price], buy_tracker_, stop_price);
+        }
+        if (!sell_tracker_.isEmpty()) {
+            uint32_t stop_price = sell_tracker_.getBestBid();
+            if (stop_price >= last_price) return popFront(sell_stops_[stop_price], sell_tracker_, stop_price);
+        }
+        return nullptr;
+    }
+
+private:
+    static Order* popFront(PriceLevel& level, FastPriceTracker& tracker, uint32_t stop_price) {
+        Order* order = level.head;
+        level.pop_front();
+        if (level.isEmpty()) tracker.clearPriceLevel(stop_price);
+        return order;
+    }
+};
+
+#endif
\ No newline at end of file
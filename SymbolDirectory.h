@@ -0,0 +1,96 @@
+#ifndef SYMBOLDIRECTORY_H
+#define SYMBOLDIRECTORY_H
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "OrderBook.h"
+#include "StopBook.h"
+#include "Types.h"
+
+constexpr uint32_t ALL_INSTRUMENTS = 0xFFFFFFFF; // Wildcard for instrument-scoped requests
+
+// Everything one instrument owns: its book and trackers, its stop book, the
+// last trade price that elects those stops, and the pool its orders live in.
+// The books are flat ladders of MAX_PRICE_TICKS levels per side, so each
+// instrument costs about 1.6 MB at 10,000 ticks whether it trades or not.
+struct Instrument {
+    OrderBook book;
+    StopBook stops;
+    OrderPool* pool = nullptr;
+    uint32_t last_trade_price = MAX_PRICE_TICKS; // MAX_PRICE_TICKS until the first trade
+};
+
+// Ladders are allocated and initialised at startup, so the directory caps
+// what one engine commits to them. A larger universe is split across
+// engines (see the sharded benchmark), or built with fewer MAX_PRICE_TICKS.
+constexpr size_t MAX_INSTRUMENT_BYTES = size_t(2) << 30; // 2 GiB, ~1,300 instruments at 10,000 ticks
+constexpr uint32_t MAX_INSTRUMENTS = static_cast<uint32_t>(MAX_INSTRUMENT_BYTES / sizeof(Instrument));
+
+// Startup layout of the symbol universe
+struct SymbolConfig {
+    uint32_t instruments = 1;           // 1..MAX_INSTRUMENTS
+    size_t shared_pool_orders = MAX_ORDERS;
+    // Instruments drawing from a pool of their own: {instrument id, capacity}
+    std::vector<std::pair<uint32_t, size_t>> dedicated_pools;
+};
+
+// Dense instrument id -> Instrument table. Every book and pool is allocated
+// here once, at startup; a lookup on the order path is one bounds check and
+// an array index. Instruments share one OrderPool unless configured with a
+// dedicated one, which isolates a busy symbol from exhausting the rest.
+class SymbolDirectory {
+private:
+    std::unique_ptr<Instrument[]> instruments_;
+    uint32_t count_;
+    OrderPool shared_pool_;
+    std::vector<std::unique_ptr<OrderPool>> dedicated_pools_;
+    size_t order_capacity_;
+
+    static uint32_t checkedCount(uint32_t instruments) {
+        if (instruments == 0) throw std::runtime_error("SymbolConfig: at least one instrument is required");
+        if (instruments > MAX_INSTRUMENTS) {
+            throw std::runtime_error("SymbolConfig: " + std::to_string(instruments) + " instruments need " +
+                                     std::to_string(bookBytes(instruments) >> 20) + " MiB of books; limit is " +
+                                     std::to_string(MAX_INSTRUMENTS));
+        }
+        return instruments;
+    }
+
+public:
+    // Memory the books of this many instruments take, allocated up front
+    static size_t bookBytes(uint32_t instruments) { return static_cast<size_t>(instruments) * sizeof(Instrument); }
+
+    explicit SymbolDirectory(const SymbolConfig& config = SymbolConfig())
+        : instruments_(new Instrument[checkedCount(config.instruments)]),
+          count_(config.instruments),
+          shared_pool_(config.shared_pool_orders),
+          order_capacity_(config.shared_pool_orders) {
+        for (uint32_t i = 0; i < count_; ++i) instruments_[i].pool = &shared_pool_;
+
+        for (const auto& dedicated : config.dedicated_pools) {
+            if (dedicated.first >= count_) throw std::runtime_error("Dedicated pool for unknown instrument");
+            dedicated_pools_.push_back(std::make_unique<OrderPool>(dedicated.second));
+            instruments_[dedicated.first].pool = dedicated_pools_.back().get();
+            order_capacity_ += dedicated.second;
+        }
+    }
+
+    // nullptr if the id is outside the directory
+    Instrument* find(uint32_t instrument) {
+        return instrument < count_ ? &instruments_[instrument] : nullptr;
+    }
+
+    Instrument& operator[](uint32_t instrument) { return instruments_[instrument]; }
+    const Instrument& operator[](uint32_t instrument) const { return instruments_[instrument]; }
+
+    uint32_t size() const { return count_; }
+
+    // Live orders the pools can hold between them, for sizing the order index
+    size_t orderCapacity() const { return order_capacity_; }
+};
+
+#endif
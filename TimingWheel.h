@@ -0,0 +1,126 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include "Types.h"
+
+// Hierarchical timing wheel for GTD order expiry.
+//
+// 4 levels x 256 slots of 2^TICK_SHIFT ns ticks (~1.05 ms), covering 2^32
+// ticks (~52 days) before clamping. Orders are chained into slots through
+// their intrusive timer_prev/timer_next links, so scheduling and cancelling
+// are O(1) and expiry costs O(1) per expired order. Higher levels cascade
+// down one slot at a time as the wheel turns. Orders never fire early: an
+// expiry is rounded up to the next tick, so they fire up to one tick late.
+class TimingWheel {
+public:
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t TICK_SHIFT = 20;
+    static constexpr uint64_t MAX_DELTA = (1ULL << (SLOT_BITS * LEVELS)) - 1;
+
+private:
+    Order* slots_[LEVELS * SLOTS] = {};
+    uint32_t level_count_[LEVELS] = {};
+    uint64_t current_tick_ = 0;
+
+    static uint64_t expiryTick(const Order& order) {
+        return (order.expire_time + (1ULL << TICK_SHIFT) - 1) >> TICK_SHIFT;
+    }
+
+    void place(Order* order, uint64_t expiry) {
+        uint64_t delta = (expiry > current_tick_) ? expiry - current_tick_ : 0;
+        if (delta > MAX_DELTA) {
+            delta = MAX_DELTA;
+            expiry = current_tick_ + MAX_DELTA;
+        }
+
+        uint32_t level = 0;
+        while (level + 1 < LEVELS && delta >= (1ULL << (SLOT_BITS * (level + 1)))) ++level;
+        uint16_t slot = static_cast<uint16_t>(level * SLOTS + ((expiry >> (SLOT_BITS * level)) & (SLOTS - 1)));
+
+        order->timer_slot = slot;
+        order->timer_prev = nullptr;
+        order->timer_next = slots_[slot];
+        if (slots_[slot]) slots_[slot]->timer_prev = order;
+        slots_[slot] = order;
+        level_count_[level]++;
+    }
+
+    Order* popSlot(uint32_t slot) {
+        Order* order = slots_[slot];
+        if (!order) return nullptr;
+        cancel(order);
+        return order;
+    }
+
+public:
+    // Starts the wheel at now; timestamps are in the same units as expire_time
+    void start(uint64_t now) { current_tick_ = now >> TICK_SHIFT; }
+
+    bool isEmpty() const {
+        return std::all_of(level_count_, level_count_ + LEVELS, [](uint32_t n) { return n == 0; });
+    }
+
+    // An expiry inside the current tick fires on the next one; the current
+    // slot has already been swept
+    void schedule(Order* order) { place(order, std::max(expiryTick(*order), current_tick_ + 1)); }
+
+    void cancel(Order* order) {
+        if (order->timer_slot == NO_TIMER_SLOT) return;
+        if (order->timer_prev) {
+            order->timer_prev->timer_next = order->timer_next;
+        } else {
+            slots_[order->timer_slot] = order->timer_next;
+        }
+        if (order->timer_next) order->timer_next->timer_prev = order->timer_prev;
+        level_count_[order->timer_slot / SLOTS]--;
+        order->timer_slot = NO_TIMER_SLOT;
+        order->timer_prev = nullptr;
+        order->timer_next = nullptr;
+    }
+
+    // Turn the wheel up to now, handing every expired order to on_expire
+    // (already unscheduled). Stretches where the lower levels hold nothing
+    // are skipped a whole boundary at a time, so idle gaps cost next to nothing.
+    template <typename OnExpire>
+    void advance(uint64_t now, OnExpire&& on_expire) {
+        const uint64_t target = now >> TICK_SHIFT;
+        while (current_tick_ < target) {
+            uint32_t empty_levels = 0;
+            while (empty_levels < LEVELS && level_count_[empty_levels] == 0) ++empty_levels;
+            if (empty_levels == LEVELS) {
+                current_tick_ = target;
+                return;
+            }
+            if (empty_levels > 0) {
+                // Nothing can fire or cascade before the next boundary of this level
+                uint64_t span_mask = (1ULL << (SLOT_BITS * empty_levels)) - 1;
+                uint64_t boundary = (current_tick_ | span_mask) + 1;
+                if (boundary > target) {
+                    current_tick_ = target;
+                    return;
+                }
+                current_tick_ = boundary - 1;
+            }
+
+            ++current_tick_;
+
+            // Cascade from the top so orders landing in a lower level's
+            // current slot are cascaded again in the same step
+            for (uint32_t level = LEVELS - 1; level > 0; --level) {
+                uint64_t span_mask = (1ULL << (SLOT_BITS * level)) - 1;
+                if ((current_tick_ & span_mask) != 0) continue;
+                uint32_t slot = level * SLOTS + ((current_tick_ >> (SLOT_BITS * level)) & (SLOTS - 1));
+                while (Order* order = popSlot(slot)) place(order, expiryTick(*order));
+            }
+
+            uint32_t slot = current_tick_ & (SLOTS - 1);
+            while (Order* order = popSlot(slot)) on_expire(order);
+        }
+    }
+};
+
+#endif
\ No newline at end of file
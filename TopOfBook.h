@@ -0,0 +1,136 @@
+#ifndef TOPOFBOOK_H
+#define TOPOFBOOK_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "EngineListener.h"
+#include "OrderBook.h"
+#include "Types.h"
+
+// Best bid/offer published by the matching thread for readers on other
+// cores (gateway price bands, strategy, risk).
+//
+// Each instrument's BBO sits in its own cache line behind a seqlock: the
+// writer makes the sequence odd, stores the fields and makes it even
+// again, and a reader retries until it sees the same even sequence before
+// and after its loads. The writer never waits and readers never write, so
+// any number of them can poll without slowing the matching thread beyond
+// the cache line it invalidates.
+
+struct Bbo {
+    uint32_t bid_price = MAX_PRICE_TICKS; // MAX_PRICE_TICKS while the side is empty
+    uint32_t ask_price = MAX_PRICE_TICKS;
+    uint64_t bid_qty = 0;                 // Displayed qty at the touch
+    uint64_t ask_qty = 0;
+
+    bool operator==(const Bbo& other) const {
+        return bid_price == other.bid_price && ask_price == other.ask_price &&
+               bid_qty == other.bid_qty && ask_qty == other.ask_qty;
+    }
+    bool operator!=(const Bbo& other) const { return !(*this == other); }
+};
+
+class TopOfBookTable {
+private:
+    // Fields are relaxed atomics so a torn read is a retry, not a data race
+    struct alignas(64) Record {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint32_t> bid_price{MAX_PRICE_TICKS};
+        std::atomic<uint32_t> ask_price{MAX_PRICE_TICKS};
+        std::atomic<uint64_t> bid_qty{0};
+        std::atomic<uint64_t> ask_qty{0};
+    };
+    static_assert(sizeof(Record) == 64, "One BBO record per cache line");
+
+    std::unique_ptr<Record[]> records_;
+    std::vector<Bbo> last_;     // Writer's copy, so an unchanged BBO never touches the shared line
+    uint32_t instruments_;
+
+    // A table built smaller than the engine's SymbolDirectory must fail
+    // loudly, not write past its records
+    void check(uint32_t instrument) const {
+        if (instrument >= instruments_) throw std::out_of_range("TopOfBookTable: instrument outside the table");
+    }
+
+public:
+    // One record per instrument id; size it from the engine's SymbolConfig
+    explicit TopOfBookTable(uint32_t instruments = 1)
+        : records_(new Record[instruments]), last_(instruments), instruments_(instruments) {}
+
+    uint32_t size() const { return instruments_; }
+
+    // --- Writer: the matching thread only ---
+
+    void publish(uint32_t instrument, const Bbo& bbo) {
+        check(instrument);
+        if (bbo == last_[instrument]) return;
+        last_[instrument] = bbo;
+
+        Record& r = records_[instrument];
+        const uint64_t seq = r.sequence.load(std::memory_order_relaxed);
+        r.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.bid_price.store(bbo.bid_price, std::memory_order_relaxed);
+        r.ask_price.store(bbo.ask_price, std::memory_order_relaxed);
+        r.bid_qty.store(bbo.bid_qty, std::memory_order_relaxed);
+        r.ask_qty.store(bbo.ask_qty, std::memory_order_relaxed);
+        r.sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // --- Readers: any thread ---
+
+    // A consistent snapshot; spins only while a publish is in flight
+    Bbo read(uint32_t instrument) const {
+        check(instrument);
+        const Record& r = records_[instrument];
+        Bbo bbo;
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = r.sequence.load(std::memory_order_acquire);
+            bbo.bid_price = r.bid_price.load(std::memory_order_relaxed);
+            bbo.ask_price = r.ask_price.load(std::memory_order_relaxed);
+            bbo.bid_qty = r.bid_qty.load(std::memory_order_relaxed);
+            bbo.ask_qty = r.ask_qty.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = r.sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return bbo;
+    }
+
+    // Publishes so far; changes whenever the BBO does
+    uint64_t version(uint32_t instrument) const {
+        check(instrument);
+        return records_[instrument].sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+// Listener that republishes an instrument's BBO once each engine operation
+// on it has completed. Reading the touch is two tracker lookups and two
+// level aggregates; the seqlock write is skipped when nothing moved.
+class TopOfBookListener : public NullListener {
+private:
+    TopOfBookTable* table_;
+
+public:
+    explicit TopOfBookListener(TopOfBookTable* table) : table_(table) {}
+
+    void onBookUpdate(uint32_t instrument, const OrderBook& book) {
+        Bbo bbo;
+        // getBestBid() reports an empty side as 0, a valid price, so test first
+        if (!book.bid_tracker_.isEmpty()) {
+            bbo.bid_price = book.bid_tracker_.getBestBid();
+            bbo.bid_qty = book.bids_[bbo.bid_price].total_qty;
+        }
+        if (!book.ask_tracker_.isEmpty()) {
+            bbo.ask_price = book.ask_tracker_.getBestAsk();
+            bbo.ask_qty = book.asks_[bbo.ask_price].total_qty;
+        }
+        table_->publish(instrument, bbo);
+    }
+};
+
+#endif
@@ -1,38 +1,105 @@
 #ifndef TYPES_H
 #define TYPES_H
 
-#include <array>
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 
 constexpr size_t MAX_ORDERS = 1000000;
 constexpr uint32_t MAX_PRICE_TICKS = 10000;
+constexpr uint16_t NO_TIMER_SLOT = 0xFFFF;
+
+enum class OrderType : uint8_t {
+    Limit,
+    Market,     // Sweeps at any price; never rests
+    PostOnly,   // Rejected instead of crossing; only ever adds liquidity
+    Stop,       // Parked until a trade prints through stop_price, then Market
+    StopLimit,  // Parked until a trade prints through stop_price, then Limit
+};
+
+enum class TimeInForce : uint8_t {
+    GTC,        // Rests until filled or cancelled
+    IOC,        // Fills what it can, remainder dropped
+    FOK,        // Fills completely on entry or is rejected untouched
+    GTD,        // Rests like GTC until expire_time, then expires
+};
+
+// Self-trade prevention, applied by the aggressor when it meets a resting
+// order with the same owner
+enum class StpMode : uint8_t {
+    None,               // Owners are ignored; self-trades print
+    CancelResting,      // Cancel the resting order, keep matching
+    CancelAggressor,    // Cancel the aggressor's remainder
+    CancelBoth,         // Cancel both
+    DecrementAndCancel, // Reduce both by the smaller open qty; cancel whichever hits zero
+};
+
+enum class OrderState : uint8_t {
+    Inbound,    // Being matched, not on any book
+    Resting,    // Queued on the order book
+    Stopped,    // Parked in the stop book until its trigger price trades
+};
 
 struct Order {
     uint64_t id;
     uint32_t price;
-    uint32_t qty;
+    uint32_t qty;             // Displayed open qty
+    uint32_t peak_qty = 0;    // Iceberg display size, 0 for a plain order
+    uint32_t reserve_qty = 0; // Iceberg hidden reserve behind the displayed slice
+    uint32_t stop_price = 0;  // Trigger price for Stop/StopLimit
+    uint32_t owner = 0;       // Participant/account id, for self-trade prevention
+    uint32_t instrument = 0;  // Symbol directory slot of the book it belongs to
     bool is_buy;
+    OrderType type = OrderType::Limit;
+    TimeInForce tif = TimeInForce::GTC;
+    OrderState state = OrderState::Inbound;
+    StpMode stp = StpMode::None;
     
     // Intrusive linked list pointers for O(1) removal
     Order* prev = nullptr;
     Order* next = nullptr;
+
+    // GTD expiry, chained into a TimingWheel slot the same way
+    uint64_t expire_time = 0;
+    Order* timer_prev = nullptr;
+    Order* timer_next = nullptr;
+    uint16_t timer_slot = NO_TIMER_SLOT;
 };
 
-// Zero-allocation object pool
+// Raw order struct coming from the "network"
+struct RawOrder { 
+    uint64_t id; 
+    uint32_t price; 
+    uint32_t qty; 
+    bool is_buy; 
+    OrderType type = OrderType::Limit;
+    TimeInForce tif = TimeInForce::GTC;
+    uint32_t display_qty = 0; // Iceberg peak, 0 shows the full qty
+    uint32_t stop_price = 0;  // Trigger price for Stop/StopLimit
+    uint64_t expire_time = 0; // GTD expiry, same clock as advanceTime
+    uint32_t owner = 0;       // Participant/account id
+    StpMode stp = StpMode::None;
+    uint32_t instrument = 0;  // Dense instrument id, see SymbolDirectory
+};
+
+// Zero-allocation object pool, sized once at startup
 class OrderPool {
 private:
-    std::array<Order, MAX_ORDERS> pool_;
-    std::array<size_t, MAX_ORDERS> free_list_;
+    std::vector<Order> pool_;
+    std::vector<size_t> free_list_;
     size_t free_idx_;
 
 public:
-    OrderPool() : free_idx_(MAX_ORDERS) {
-        for (size_t i = 0; i < MAX_ORDERS; ++i) {
-            free_list_[i] = MAX_ORDERS - 1 - i;
+    explicit OrderPool(size_t capacity = MAX_ORDERS)
+        : pool_(capacity), free_list_(capacity), free_idx_(capacity) {
+        for (size_t i = 0; i < capacity; ++i) {
+            free_list_[i] = capacity - 1 - i;
         }
     }
 
+    size_t capacity() const { return pool_.size(); }
+
     Order* allocate(uint64_t id, uint32_t price, uint32_t qty, bool is_buy) {
         if (free_idx_ == 0) throw std::runtime_error("OrderPool exhausted");
         size_t idx = free_list_[--free_idx_];
@@ -41,8 +108,19 @@ public:
         order->price = price;
         order->qty = qty;
         order->is_buy = is_buy;
+        order->peak_qty = 0;
+        order->reserve_qty = 0;
+        order->stop_price = 0;
+        order->owner = 0;
+        order->instrument = 0;
+        order->type = OrderType::Limit;
+        order->tif = TimeInForce::GTC;
+        order->state = OrderState::Inbound;
+        order->stp = StpMode::None;
         order->prev = nullptr;
         order->next = nullptr;
+        order->expire_time = 0;
+        order->timer_slot = NO_TIMER_SLOT;
         return order;
     }
 
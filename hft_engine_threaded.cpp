@@ -1,6 +1,8 @@
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <chrono>
 #include <random>
 #include <cstdint>
@@ -8,233 +10,81 @@
 #include <memory>
 #include <atomic>
 #include <thread>
-
-constexpr size_t MAX_ORDERS = 1000000;
-constexpr uint32_t MAX_PRICE_TICKS = 4096;
-
-// --- 1. Types & Memory Management ---
-struct Order {
-    uint64_t id;
-    uint32_t price;
-    uint32_t qty;
-    bool is_buy;
-    Order* prev = nullptr;
-    Order* next = nullptr;
-};
-
-// Raw order struct coming from the "network"
-struct RawOrder { 
-    uint64_t id; 
-    uint32_t price; 
-    uint32_t qty; 
-    bool is_buy; 
-};
-
-class OrderPool {
-private:
-    std::array<Order, MAX_ORDERS> pool_;
-    std::array<size_t, MAX_ORDERS> free_list_;
-    size_t free_idx_;
-
-public:
-    OrderPool() : free_idx_(MAX_ORDERS) {
-        for (size_t i = 0; i < MAX_ORDERS; ++i) {
-            free_list_[i] = MAX_ORDERS - 1 - i;
-        }
-    }
-
-    Order* allocate(uint64_t id, uint32_t price, uint32_t qty, bool is_buy) {
-        if (free_idx_ == 0) throw std::runtime_error("OrderPool exhausted");
-        size_t idx = free_list_[--free_idx_];
-        Order* order = &pool_[idx];
-        order->id = id; order->price = price; order->qty = qty; order->is_buy = is_buy;
-        order->prev = nullptr; order->next = nullptr;
-        return order;
-    }
-
-    void deallocate(Order* order) {
-        size_t idx = std::distance(pool_.data(), order);
-        free_list_[free_idx_++] = idx;
-    }
-};
-
-// --- 2. O(1) Hardware-Accelerated Price Tracker ---
-class FastPriceTracker {
-private:
-    uint64_t summary_word_ = 0;
-    uint64_t data_words_[64] = {0};
-
-public:
-    void setPriceLevel(uint32_t price) {
-        uint32_t word_idx = price / 64;
-        uint32_t bit_idx = price % 64;
-        data_words_[word_idx] |= (1ULL << bit_idx);
-        summary_word_ |= (1ULL << word_idx);
-    }
-
-    void clearPriceLevel(uint32_t price) {
-        uint32_t word_idx = price / 64;
-        uint32_t bit_idx = price % 64;
-        data_words_[word_idx] &= ~(1ULL << bit_idx);
-        if (data_words_[word_idx] == 0) {
-            summary_word_ &= ~(1ULL << word_idx);
-        }
-    }
-
-    uint32_t getBestAsk() const {
-        if (summary_word_ == 0) return MAX_PRICE_TICKS; 
-        uint32_t lowest_word = __builtin_ctzll(summary_word_);
-        uint32_t lowest_bit = __builtin_ctzll(data_words_[lowest_word]);
-        return (lowest_word * 64) + lowest_bit;
-    }
-
-    uint32_t getBestBid() const {
-        if (summary_word_ == 0) return 0; 
-        uint32_t highest_word = 63 - __builtin_clzll(summary_word_);
-        uint32_t highest_bit = 63 - __builtin_clzll(data_words_[highest_word]);
-        return (highest_word * 64) + highest_bit;
-    }
-};
-
-// --- 3. Intrusive Linked List & Order Book ---
-struct PriceLevel {
-    Order* head = nullptr;
-    Order* tail = nullptr;
-
-    bool isEmpty() const { return head == nullptr; }
-
-    void push_back(Order* order) {
-        if (!head) { head = tail = order; } 
-        else { tail->next = order; order->prev = tail; tail = order; }
-    }
-
-    Order* pop_front() {
-        if (!head) return nullptr;
-        Order* order = head;
-        head = head->next;
-        if (head) head->prev = nullptr;
-        else tail = nullptr;
-        return order;
-    }
-};
-
-class OrderBook {
-public:
-    std::array<PriceLevel, MAX_PRICE_TICKS> bids_;
-    std::array<PriceLevel, MAX_PRICE_TICKS> asks_;
-    FastPriceTracker bid_tracker_;
-    FastPriceTracker ask_tracker_;
-
-    void addOrder(Order* order) {
-        if (order->is_buy) {
-            if (bids_[order->price].isEmpty()) bid_tracker_.setPriceLevel(order->price);
-            bids_[order->price].push_back(order);
-        } else {
-            if (asks_[order->price].isEmpty()) ask_tracker_.setPriceLevel(order->price);
-            asks_[order->price].push_back(order);
-        }
-    }
-};
-
-// --- 4. Matching Engine Core ---
-class MatchingEngine {
-private:
-    OrderBook book_;
-    OrderPool pool_;
-    uint64_t trades_executed_ = 0;
-
-public:
-    void processNewOrder(uint64_t id, uint32_t price, uint32_t qty, bool is_buy) {
-        Order* inbound = pool_.allocate(id, price, qty, is_buy);
-
-        if (is_buy) matchBuyOrder(inbound);
-        else matchSellOrder(inbound);
-
-        if (inbound->qty > 0) book_.addOrder(inbound);
-        else pool_.deallocate(inbound);
-    }
-
-    uint64_t getTradesExecuted() const { return trades_executed_; }
-
-private:
-    void matchBuyOrder(Order* inbound) {
-        while (inbound->qty > 0) {
-            uint32_t best_ask = book_.ask_tracker_.getBestAsk();
-            if (best_ask > inbound->price || best_ask == MAX_PRICE_TICKS) break;
-
-            PriceLevel& level = book_.asks_[best_ask];
-            Order* resting = level.head;
-            executeTrade(inbound, resting, level, best_ask, false);
-        }
-    }
-
-    void matchSellOrder(Order* inbound) {
-        while (inbound->qty > 0) {
-            uint32_t best_bid = book_.bid_tracker_.getBestBid();
-            if (best_bid < inbound->price || best_bid == 0) break;
-
-            PriceLevel& level = book_.bids_[best_bid];
-            Order* resting = level.head;
-            executeTrade(inbound, resting, level, best_bid, true);
-        }
-    }
-
-    void executeTrade(Order* inbound, Order* resting, PriceLevel& level, uint32_t fill_price, bool is_bid_book) {
-        uint32_t traded_qty = std::min(inbound->qty, resting->qty);
-        inbound->qty -= traded_qty;
-        resting->qty -= traded_qty;
-        trades_executed_++;
-
-        if (resting->qty == 0) {
-            level.pop_front();
-            if (level.isEmpty()) {
-                if (is_bid_book) book_.bid_tracker_.clearPriceLevel(fill_price);
-                else book_.ask_tracker_.clearPriceLevel(fill_price);
-            }
-            pool_.deallocate(resting);
-        }
-    }
-};
-
-// --- 5. Lock-Free SPSC Ring Buffer ---
-template <typename T, size_t Capacity>
-class SpscQueue {
-private:
-    alignas(64) std::atomic<size_t> write_idx_{0};
-    alignas(64) std::atomic<size_t> read_idx_{0};
-    std::array<T, Capacity> buffer_;
-
-public:
-    bool push(const T& item) {
-        const size_t current_write = write_idx_.load(std::memory_order_relaxed);
-        const size_t next_write = (current_write + 1) % Capacity;
-        if (next_write == read_idx_.load(std::memory_order_acquire)) return false; 
-        
-        buffer_[current_write] = item;
-        write_idx_.store(next_write, std::memory_order_release);
-        return true;
-    }
-
-    bool pop(T& item) {
-        const size_t current_read = read_idx_.load(std::memory_order_relaxed);
-        if (current_read == write_idx_.load(std::memory_order_acquire)) return false; 
-        
-        item = buffer_[current_read];
-        read_idx_.store((current_read + 1) % Capacity, std::memory_order_release);
-        return true;
-    }
-};
-
-// --- 6. Multi-Threaded Benchmark ---
-int main() {
+#include <cstdlib>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ExecReport.h"
+#include "Journal.h"
+#include "L2Feed.h"
+#include "MatchingEngine.h"
+#include "MboFeed.h"
+#include "MpscIngress.h"
+#include "ShmSpscQueue.h"
+#include "SpscQueue.h"
+#include "TopOfBook.h"
+
+constexpr size_t INBOUND_QUEUE_CAPACITY = 65536;
+constexpr int TIMER_POLL_INTERVAL = 1024;
+constexpr int NUM_ORDERS = 500000;
+constexpr size_t CONSUMER_BATCH = 64; // Orders taken off the ring per index publish
+
+// Multi-gateway mode
+constexpr size_t NUM_GATEWAYS = 4;
+constexpr size_t INGRESS_LANE_CAPACITY = 16384;
+constexpr size_t MAX_GATEWAYS = 16;
+
+// Cross-process mode
+constexpr size_t SHM_QUEUE_CAPACITY = 65536;
+
+// Sharded mode
+constexpr uint32_t NUM_INSTRUMENTS = 64;
+constexpr size_t SHARD_QUEUE_CAPACITY = 65536;
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// --- Multi-Threaded Benchmark ---
+static void runPipelineBenchmark() {
     // Allocate heavily sized objects on the heap to prevent stack overflow
-    auto engine = std::make_unique<MatchingEngine>();
-    auto queue = std::make_unique<SpscQueue<RawOrder, 65536>>();
+    auto queue = std::make_unique<SpscQueue<RawOrder, INBOUND_QUEUE_CAPACITY>>();
+    // Exec reports are broadcast to two consumers: the publisher and a drop
+    // copy. Book changes go out separately as the market-by-order feed and
+    // as conflated L2 updates, flushed once per consumer batch. The BBO is
+    // published through a seqlock the producer reads as a gateway would.
+    // Every order the engine consumes is journaled, in consumption order, by
+    // a separate thread with one fdatasync per group.
+    auto reports = std::make_unique<ReportBroadcast>(2);
+    auto mbo = std::make_unique<MboQueue>();
+    auto l2 = std::make_unique<L2Queue>();
+    // Per-instrument market-data state is sized from the engine's directory
+    SymbolConfig symbols;
+    auto conflator = std::make_unique<L2Conflator>(symbols.instruments);
+    auto top = std::make_unique<TopOfBookTable>(symbols.instruments);
+    auto journal_queue = std::make_unique<JournalQueue<RawOrder>>();
+    const char* journal_path = std::getenv("NANOMATCH_JOURNAL");
+    std::string path = journal_path ? journal_path : "/tmp/nanomatch.journal";
+    unlink(path.c_str()); // A fresh day
+    JournalConfig journal_config;
+    journal_config.durability = JournalDurability::GroupCommit;
+    JournalWriter<RawOrder> journal(journal_queue.get(), path, journal_config);
+    JournalSequencer<RawOrder> sequencer(journal_queue.get(), journal.nextSequence());
+    using BookDataListener = TeeListener<L2DirtyListener, TopOfBookListener>;
+    using MarketDataListener = TeeListener<MboFeedListener, BookDataListener>;
+    using PipelineListener = TeeListener<BroadcastReportListener, MarketDataListener>;
+    auto engine = std::make_unique<MatchingEngine<PipelineListener>>(symbols,
+        PipelineListener(BroadcastReportListener(reports.get()),
+                         MarketDataListener(MboFeedListener(mbo.get()),
+                                            BookDataListener(L2DirtyListener(conflator.get()),
+                                                             TopOfBookListener(top.get())))));
     
-    // Atomic flag to signal the consumer when ingestion is finished
+    // Atomic flags to signal downstream stages when their upstream is finished
     std::atomic<bool> producer_done{false};
+    std::atomic<bool> consumer_done{false};
 
-    const int NUM_ORDERS = 500000; 
     std::vector<RawOrder> test_orders(NUM_ORDERS);
     
     std::random_device rd;
@@ -242,9 +92,17 @@ int main() {
     std::uniform_int_distribution<uint32_t> price_dist(2000, 2050); 
     std::uniform_int_distribution<uint32_t> qty_dist(10, 100);
     std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> gtd_dist(0, 9);
+    std::uniform_int_distribution<uint64_t> ttl_dist(1000000, 20000000); // 1-20 ms
 
+    // Roughly 10% of orders are GTD so the timing wheel sees real traffic;
+    // expire_time holds a TTL here and is stamped absolute on send
     for (int i = 0; i < NUM_ORDERS; ++i) {
         test_orders[i] = {(uint64_t)i, price_dist(gen), qty_dist(gen), (bool)side_dist(gen)};
+        if (gtd_dist(gen) == 0) {
+            test_orders[i].tif = TimeInForce::GTD;
+            test_orders[i].expire_time = ttl_dist(gen);
+        }
     }
 
     std::cout << "Starting multi-threaded matching engine benchmark..." << std::endl;
@@ -252,34 +110,145 @@ int main() {
     auto start = std::chrono::high_resolution_clock::now();
 
     // --- Thread 1: The Producer (Ingestion / Network) ---
+    uint64_t marketable_seen = 0;
     std::thread producer([&]() {
         for (int i = 0; i < NUM_ORDERS; ++i) {
+            // Gateway-side check against the last published BBO, no lock taken
+            const RawOrder& order = test_orders[i];
+            Bbo bbo = top->read(0);
+            if (order.is_buy ? (bbo.ask_qty > 0 && order.price >= bbo.ask_price)
+                             : (bbo.bid_qty > 0 && order.price <= bbo.bid_price)) {
+                marketable_seen++;
+            }
+
             // Spin-lock if the queue is full (simulating handling network micro-bursts)
-            while (!queue->push(test_orders[i])) {
+            RawOrder* slot;
+            while (!(slot = queue->claim())) {
                 // In a real system, you might _mm_pause() here
             }
+            // Build the order straight in the ring slot
+            *slot = test_orders[i];
+            if (slot->tif == TimeInForce::GTD) slot->expire_time += nowNs();
+            queue->commit();
         }
         producer_done.store(true, std::memory_order_release);
     });
 
     // --- Thread 2: The Consumer (Matching Engine Core) ---
     std::thread consumer([&]() {
-        RawOrder order;
+        RawOrder batch[CONSUMER_BATCH];
+        int since_poll = 0;
+        // Publish the net L2 change of everything since the last flush
+        auto flushL2 = [&]() {
+            conflator->flush(*engine, [&](const L2Update& update) {
+                while (!l2->push(update)) {
+                    // Backpressure: the market-data thread is a full ring behind
+                }
+            });
+        };
+        // Engine clock as last passed to advanceTime; journaled with each
+        // order so a replay expires GTD orders at the same points
+        uint64_t clock = 0;
+        auto tick = [&]() {
+            clock = nowNs();
+            engine->advanceTime(clock);
+        };
+        // Returns false once the queue is empty
+        auto processBatch = [&]() {
+            size_t n = queue->popN(batch, CONSUMER_BATCH);
+            for (size_t i = 0; i < n; ++i) {
+                sequencer.append(batch[i], clock);
+                engine->processNewOrder(batch[i]);
+            }
+            // Reading the clock per order is too expensive; poll the timers in batches
+            since_poll += static_cast<int>(n);
+            if (since_poll >= TIMER_POLL_INTERVAL) {
+                tick();
+                since_poll = 0;
+            }
+            flushL2();
+            return n > 0;
+        };
+        tick();
         // Keep spinning while the producer is active
         while (!producer_done.load(std::memory_order_acquire)) {
-            while (queue->pop(order)) {
-                engine->processNewOrder(order.id, order.price, order.qty, order.is_buy);
-            }
+            while (processBatch()) {}
+            tick();
         }
         // Producer is done, drain any remaining orders in the queue
-        while (queue->pop(order)) {
-            engine->processNewOrder(order.id, order.price, order.qty, order.is_buy);
+        while (processBatch()) {}
+        tick();
+        flushL2();
+        consumer_done.store(true, std::memory_order_release);
+    });
+
+    // --- Thread 3: The Publisher (Execution Reports / Downstream) ---
+    uint64_t fills_published = 0;
+    uint64_t volume_published = 0;
+    uint64_t expiries_published = 0;
+    std::thread publisher([&]() {
+        auto drain = [&]() {
+            while (reports->poll(0, [&](const ExecReport& report) {
+                if (report.type == ExecType::Filled) {
+                    fills_published++;
+                    volume_published += report.qty;
+                } else if (report.type == ExecType::Cancelled && report.reason == CancelReason::Expired) {
+                    expiries_published++;
+                }
+            })) {}
+        };
+        while (!consumer_done.load(std::memory_order_acquire)) {
+            drain();
+        }
+        drain();
+    });
+
+    // --- Thread 4: Drop Copy (second reader of the same report ring) ---
+    uint64_t reports_copied = 0;
+    std::thread drop_copy([&]() {
+        auto drain = [&]() {
+            while (reports->poll(1, [&](const ExecReport&) { reports_copied++; })) {}
+        };
+        while (!consumer_done.load(std::memory_order_acquire)) {
+            drain();
+        }
+        drain();
+    });
+
+    // --- Thread 5: Market Data (MBO packets and conflated L2 updates) ---
+    MboPacketizer feed(mbo.get(), 1);
+    uint64_t feed_bytes = 0;
+    uint64_t l2_updates = 0;
+    std::thread market_data([&]() {
+        // Stands in for a UDP multicast send
+        auto send = [&](const char*, size_t len) { feed_bytes += len; };
+        L2Update updates[CONSUMER_BATCH];
+        auto drain = [&]() {
+            feed.poll(send);
+            while (size_t n = l2->popN(updates, CONSUMER_BATCH)) l2_updates += n;
+        };
+        while (!consumer_done.load(std::memory_order_acquire)) {
+            drain();
+        }
+        drain();
+    });
+
+    // --- Thread 6: Journal (write-ahead log of the consumed orders) ---
+    std::thread journaler([&]() {
+        while (!consumer_done.load(std::memory_order_acquire)) {
+            journal.poll();
         }
+        journal.poll();
+        journal.sync();
     });
 
-    // Wait for both threads to finish
+    // Wait for all threads to finish
     producer.join();
     consumer.join();
+    publisher.join();
+    drop_copy.join();
+    market_data.join();
+    journaler.join();
 
     auto end = std::chrono::high_resolution_clock::now();
     
@@ -289,8 +258,278 @@ int main() {
     std::cout << "--- Matching Engine Results ---" << std::endl;
     std::cout << "Orders Processed: " << NUM_ORDERS << std::endl;
     std::cout << "Trades Executed:  " << engine->getTradesExecuted() << std::endl;
+    std::cout << "Fills Published:  " << fills_published << " (" << volume_published << " shares)" << std::endl;
+    std::cout << "GTD Expiries:     " << expiries_published << std::endl;
+    std::cout << "Drop Copy:        " << reports_copied << " reports" << std::endl;
+    std::cout << "MBO Feed:         " << feed.nextSequence() - 1 << " messages in " << feed.packetsSent()
+              << " packets (" << feed_bytes << " bytes)" << std::endl;
+    std::cout << "L2 Feed:          " << l2_updates << " conflated level updates" << std::endl;
+    std::cout << "Top of Book:      " << top->version(0) << " BBO changes published, " << marketable_seen
+              << " orders marketable at the gateway" << std::endl;
+    std::cout << "Journal:          " << journal.durableSequence() << " orders durable in " << journal.groups()
+              << " groups, " << journal.syncs() << " fdatasyncs (" << journal.bytesWritten() << " bytes)" << std::endl;
     std::cout << "Total Time:       " << elapsed_ms.count() << " ms" << std::endl;
     std::cout << "Pipeline Latency: " << elapsed_ns.count() / NUM_ORDERS << " ns/order" << std::endl;
+}
+
+// --- Multi-Gateway Ingress Benchmark ---
+// Several gateway threads feed one matching thread, each through its own
+// MpscIngress lane; the matcher serves the lanes round-robin.
+static void runIngressBenchmark(const std::vector<RawOrder>& orders, size_t num_gateways) {
+    using Ingress = MpscIngress<RawOrder, INGRESS_LANE_CAPACITY, MAX_GATEWAYS>;
+    auto ingress = std::make_unique<Ingress>(num_gateways);
+    auto engine = std::make_unique<MatchingEngine<>>();
+    std::atomic<size_t> gateways_done{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Gateway g sends every num_gateways-th order, so ids stay unique
+    std::vector<std::thread> gateways;
+    for (size_t g = 0; g < num_gateways; ++g) {
+        gateways.emplace_back([&, g]() {
+            for (size_t i = g; i < orders.size(); i += num_gateways) {
+                RawOrder* slot;
+                while (!(slot = ingress->claim(g))) {
+                    // Lane full: only this gateway backs off
+                }
+                *slot = orders[i];
+                ingress->commit(g);
+            }
+            gateways_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::thread matcher([&]() {
+        auto process = [&](const RawOrder& order, size_t) { engine->processNewOrder(order); };
+        while (gateways_done.load(std::memory_order_acquire) < num_gateways) ingress->poll(process);
+        while (ingress->poll(process)) {}
+    });
+
+    for (auto& gateway : gateways) gateway.join();
+    matcher.join();
+
+    std::chrono::duration<double, std::milli> elapsed_ms = std::chrono::steady_clock::now() - start;
+
+    std::cout << "--- " << num_gateways << " gateways -> 1 matching thread: " << elapsed_ms.count()
+              << " ms, " << engine->getTradesExecuted() << " trades ---" << std::endl;
+    for (size_t g = 0; g < num_gateways; ++g) {
+        std::cout << "  lane " << g << ": " << ingress->delivered(g) << " delivered, "
+                  << ingress->rejected(g) << " full-lane retries" << std::endl;
+    }
+}
+
+// --- Cross-Process Benchmark ---
+// A forked gateway process feeds the matching process through a
+// ShmSpscQueue in a memfd; the child attaches to the inherited descriptor.
+static void runCrossProcessBenchmark(const std::vector<RawOrder>& orders) {
+    using ShmQueue = ShmSpscQueue<RawOrder, SHM_QUEUE_CAPACITY>;
+    int fd = memfd_create("nanomatch-orders", 0);
+    if (fd < 0) throw std::runtime_error("memfd_create failed");
+    int child_fd = dup(fd);
+    if (child_fd < 0) throw std::runtime_error("dup failed");
+    auto queue = std::make_unique<ShmQueue>(fd, ShmMode::Create);
+    auto engine = std::make_unique<MatchingEngine<>>();
+
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (pid < 0) throw std::runtime_error("fork failed");
+    if (pid == 0) {
+        // Gateway process: its own mapping of the same memory. Nothing may
+        // unwind out of here into the parent's code.
+        try {
+            ShmQueue gateway(child_fd, ShmMode::Open);
+            for (const RawOrder& order : orders) {
+                RawOrder* slot;
+                while (!(slot = gateway.claim())) {
+                    // Backpressure: the matching process is a full ring behind
+                }
+                *slot = order;
+                gateway.commit();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "gateway process: " << e.what() << std::endl;
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(child_fd);
+
+    RawOrder batch[CONSUMER_BATCH];
+    size_t received = 0;
+    int status = 0;
+    bool gateway_exited = false;
+    while (received < orders.size()) {
+        size_t n = queue->popN(batch, CONSUMER_BATCH);
+        for (size_t i = 0; i < n; ++i) engine->processNewOrder(batch[i]);
+        received += n;
+        if (n > 0) continue;
+        // Idle: a gateway that died short of its orders would leave this
+        // loop spinning. Once it has exited, one more empty pop means
+        // everything it committed has been drained.
+        if (gateway_exited) {
+            std::string how = WIFEXITED(status) ? "exit " + std::to_string(WEXITSTATUS(status))
+                                                : "signal " + std::to_string(WTERMSIG(status));
+            throw std::runtime_error("gateway process ended (" + how + ") after " + std::to_string(received) +
+                                     " of " + std::to_string(orders.size()) + " orders");
+        }
+        gateway_exited = (waitpid(pid, &status, WNOHANG) == pid);
+    }
+    if (!gateway_exited) waitpid(pid, &status, 0);
+
+    std::chrono::duration<double, std::milli> elapsed_ms = std::chrono::steady_clock::now() - start;
+    std::cout << "--- gateway process -> matching process: " << elapsed_ms.count() << " ms, "
+              << engine->getTradesExecuted() << " trades, gateway exit "
+              << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << " ---" << std::endl;
+}
+
+// --- Sharded Multi-Core Benchmark ---
+// A router thread hashes each instrument onto one of N matching shards. Each
+// shard owns its engine (books for its instruments only) and its inbound
+// SPSC queue, so shards share nothing but the router.
+
+struct TimedOrder {
+    RawOrder order;
+    uint64_t routed_ns; // Stamped by the router, for time spent queued
+};
+
+// The router runs unpaced, so shard queues sit near full and the wait
+// dominates router-to-match time; it is reported apart from match time
+struct Shard {
+    SpscQueue<TimedOrder, SHARD_QUEUE_CAPACITY> queue;
+    std::unique_ptr<MatchingEngine<>> engine;
+    std::vector<uint64_t> wait_ns;  // Router stamp to start of the order's batch
+    uint64_t match_ns = 0;          // Clock read per batch, not per order
+};
+
+// Where an instrument lives: its shard, and its dense id in that shard's directory
+struct Route {
+    uint32_t shard;
+    uint32_t local_instrument;
+};
+
+static uint32_t shardOf(uint32_t instrument, uint32_t num_shards) {
+    return static_cast<uint32_t>((instrument * 2654435761ULL) >> 16) % num_shards;
+}
+
+static void runShardedBenchmark(const std::vector<RawOrder>& orders, uint32_t num_shards) {
+    // Hash each instrument once at startup; the router then does a table lookup
+    std::vector<Route> routes(NUM_INSTRUMENTS);
+    std::vector<uint32_t> instruments_per_shard(num_shards, 0);
+    for (uint32_t i = 0; i < NUM_INSTRUMENTS; ++i) {
+        uint32_t shard = shardOf(i, num_shards);
+        routes[i] = {shard, instruments_per_shard[shard]++};
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    for (uint32_t s = 0; s < num_shards; ++s) {
+        SymbolConfig symbols;
+        symbols.instruments = std::max<uint32_t>(instruments_per_shard[s], 1);
+        symbols.shared_pool_orders = orders.size();
+        auto shard = std::make_unique<Shard>();
+        shard->engine = std::make_unique<MatchingEngine<>>(symbols);
+        shard->wait_ns.reserve(orders.size());
+        shards.push_back(std::move(shard));
+    }
+
+    std::atomic<bool> router_done{false};
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread router([&]() {
+        for (const RawOrder& raw : orders) {
+            const Route& route = routes[raw.instrument];
+            auto& queue = shards[route.shard]->queue;
+            TimedOrder* slot;
+            while (!(slot = queue.claim())) {
+                // Backpressure from a slow shard stalls the router
+            }
+            slot->order = raw;
+            slot->order.instrument = route.local_instrument;
+            slot->routed_ns = nowNs();
+            queue.commit();
+        }
+        router_done.store(true, std::memory_order_release);
+    });
+
+    std::vector<std::thread> matchers;
+    for (auto& shard_ptr : shards) {
+        Shard* shard = shard_ptr.get();
+        matchers.emplace_back([shard, &router_done]() {
+            TimedOrder batch[CONSUMER_BATCH];
+            auto drain = [&]() {
+                while (size_t n = shard->queue.popN(batch, CONSUMER_BATCH)) {
+                    uint64_t batch_start = nowNs();
+                    for (size_t i = 0; i < n; ++i) shard->wait_ns.push_back(batch_start - batch[i].routed_ns);
+                    for (size_t i = 0; i < n; ++i) shard->engine->processNewOrder(batch[i].order);
+                    shard->match_ns += nowNs() - batch_start;
+                }
+            };
+            while (!router_done.load(std::memory_order_acquire)) drain();
+            drain();
+        });
+    }
+
+    router.join();
+    for (auto& matcher : matchers) matcher.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "--- " << num_shards << " shard(s): "
+              << std::fixed << std::setprecision(2) << orders.size() / elapsed.count() / 1e6
+              << " M orders/s (" << elapsed.count() * 1e3 << " ms) ---" << std::endl;
+    for (uint32_t s = 0; s < num_shards; ++s) {
+        std::vector<uint64_t>& wait = shards[s]->wait_ns;
+        if (wait.empty()) {
+            std::cout << "  shard " << s << ": idle" << std::endl;
+            continue;
+        }
+        std::sort(wait.begin(), wait.end());
+        std::cout << "  shard " << s << ": " << wait.size() << " orders, "
+                  << shards[s]->engine->getTradesExecuted() << " trades, match "
+                  << shards[s]->match_ns / wait.size() << " ns/order, queue wait p50 "
+                  << wait[wait.size() / 2] << " ns, p99 " << wait[wait.size() * 99 / 100] << " ns" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// Usage: hft_engine_threaded [max_shards]
+// Runs the single-engine pipeline, the multi-gateway ingress benchmark, then
+// the sharded benchmark for 1..max_shards matching threads (default: one per
+// core left over after the router).
+int main(int argc, char** argv) {
+    runPipelineBenchmark();
+
+    std::vector<RawOrder> orders(NUM_ORDERS);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> instrument_dist(0, NUM_INSTRUMENTS - 1);
+    std::uniform_int_distribution<uint32_t> price_dist(2000, 2050);
+    std::uniform_int_distribution<uint32_t> qty_dist(10, 100);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        orders[i] = {(uint64_t)i, price_dist(gen), qty_dist(gen), (bool)side_dist(gen)};
+    }
+
+    std::cout << std::endl << "Starting multi-gateway ingress benchmark..." << std::endl;
+    runIngressBenchmark(orders, NUM_GATEWAYS);
+
+    std::cout << std::endl << "Starting cross-process (shared memory) benchmark..." << std::endl;
+    try {
+        runCrossProcessBenchmark(orders);
+    } catch (const std::exception& e) {
+        std::cout << "Cross-process benchmark aborted: " << e.what() << std::endl;
+    }
+
+    uint32_t cores = std::max(std::thread::hardware_concurrency(), 2u);
+    uint32_t max_shards = (argc > 1) ? static_cast<uint32_t>(std::atoi(argv[1])) : cores - 1;
+    if (max_shards == 0) return 0;
+
+    for (RawOrder& order : orders) order.instrument = instrument_dist(gen);
+
+    std::cout << std::endl << "Starting sharded benchmark (" << NUM_INSTRUMENTS
+              << " instruments, up to " << max_shards << " shards)..." << std::endl;
+    for (uint32_t shards = 1; shards <= max_shards; ++shards) {
+        runShardedBenchmark(orders, shards);
+    }
 
     return 0;
-}
\ No newline at end of file
+}